@@ -2,30 +2,16 @@
 #include "sprite_renderer.h"
 #include "resource_manager.h"
 #include <glm/glm.hpp>
-#include "game_level.h"
-#include "ball_object.h"
 #include "particle_generator.h"
 #include "post_processor.h"
 #include "textRenderer.h"
 #include <iostream>
-#include <algorithm>
 #include <irrKlang/irrKlang.h>
 #include <sstream>
 
 using namespace irrklang;
 
-// Initial size of the player paddle
-const glm::vec2 PLAYER_SIZE(100.0f, 20.0f);
-// Initial velocity of the player paddle
-const float PLAYER_VELOCITY(500.0f);
-// Initial velocity of the ball
-const glm::vec2 INITIAL_BALL_VELOCITY(100.0f, -350.0f);
-// Radius of the ball object
-const float BALL_RADIUS = 12.5f;
-
-GameObject* Player;
 SpriteRenderer *Renderer;
-BallObject* Ball;
 ParticleGenerator *Particles;
 PostProcessor *Effects;
 ISoundEngine *SoundEngine = createIrrKlangDevice();
@@ -33,16 +19,87 @@ ISound* backgroundMusic;
 ISound* backgroundMusicRev;
 ISoundEffectControl *bkgMusicFXControl;
 TextRenderer *Text;
+Texture2D PowerUpTextures[POWERUP_TYPES]; // by PowerUpType, looked up once in Init
+
+// Number of particles shared by the trails of all balls
+const unsigned int PARTICLE_BUDGET = 4000;
+
+// Particles thrown off by every destroyed brick
+const unsigned int BRICK_BURST = 12;
+
+// draws a simulation object with the given sprite
+void DrawObject(const GameObject& object, Texture2D sprite)
+{
+    Renderer->DrawSprite(sprite, object.Position, object.Size, object.Rotation, object.Color);
+}
+
+// interpolates between two tick positions, snapping when the object was teleported (e.g. reset)
+glm::vec2 Interpolate(glm::vec2 previous, glm::vec2 current, float alpha, float maxDistance)
+{
+    if (glm::length(current - previous) > maxDistance)
+        return current;
+    return glm::mix(previous, current, glm::clamp(alpha, 0.0f, 1.0f));
+}
+
+// GameKey bits of the held keyboard keys
+unsigned int KeyboardKeys(const bool* keys)
+{
+    unsigned int mask = 0;
+    if (keys[GLFW_KEY_A] || keys[GLFW_KEY_LEFT])
+        mask |= GAME_KEY_LEFT;
+    if (keys[GLFW_KEY_D] || keys[GLFW_KEY_RIGHT])
+        mask |= GAME_KEY_RIGHT;
+    if (keys[GLFW_KEY_SPACE])
+        mask |= GAME_KEY_LAUNCH;
+    if (keys[GLFW_KEY_ENTER])
+        mask |= GAME_KEY_CONFIRM;
+    if (keys[GLFW_KEY_W])
+        mask |= GAME_KEY_NEXT_LEVEL;
+    if (keys[GLFW_KEY_S])
+        mask |= GAME_KEY_PREV_LEVEL;
+    return mask;
+}
 
-float ShakeTime = 0.0f;
+// music follows the effect state of the simulation
+bool confuseActive = false, chaosActive = false, slowMoActive = false;
+void UpdateMusic(const Simulation& sim)
+{
+    if (sim.Confuse != confuseActive)
+    {
+        ISound* from = sim.Confuse ? backgroundMusic : backgroundMusicRev;
+        ISound* to = sim.Confuse ? backgroundMusicRev : backgroundMusic;
+        from->setIsPaused(true);
+        to->setPlayPosition(from->getPlayLength() - from->getPlayPosition());
+        to->setIsPaused(false);
+        confuseActive = sim.Confuse;
+    }
+    // the chaos shown on the win screen leaves the music alone
+    bool chaos = sim.Chaos && sim.State == GAME_ACTIVE;
+    if (chaos != chaosActive)
+    {
+        if (bkgMusicFXControl)
+        {
+            if (chaos)
+                bkgMusicFXControl->enableDistortionSoundEffect();
+            else
+                bkgMusicFXControl->disableDistortionSoundEffect();
+        }
+        else
+            std::cout << "This device or sound does not support sound effects.\n";
+        chaosActive = chaos;
+    }
+    if (sim.SlowMo != slowMoActive)
+    {
+        backgroundMusic->setPlaybackSpeed(sim.SlowMo ? 0.5f : 1.0f);
+        slowMoActive = sim.SlowMo;
+    }
+}
 
 
 Game::Game(unsigned int width, unsigned int height)
-    : State(GAME_ACTIVE), Keys(), Width(width), Height(height)
+    : Keys(), Width(width), Height(height), Sim(width, height), Seed(0), Recording(nullptr), Playback(nullptr),
+      Session(nullptr), Link(nullptr), Pilot(nullptr), Watcher(nullptr), PrevPlayerPosition(0.0f), PrevOpponentPosition(0.0f), TickDt(0.0f)
 {
-    std::vector<GameLevel> Levels;
-    unsigned int           Level;
-    Lives = 3;
 }
 
 Game::~Game() {
@@ -72,147 +129,134 @@ void Game::Init() {
     ResourceManager::LoadTexture("textures/block_solid.png", false, "block_solid");
     ResourceManager::LoadTexture("textures/paddle.png", true, "paddle");
     ResourceManager::LoadTexture("textures/particle.png", true, "particle");
-    ResourceManager::LoadTexture("textures/powerup_chaos.png", true, "powerup_chaos");
-    ResourceManager::LoadTexture("textures/powerup_confuse.png", true, "powerup_confuse");
-    ResourceManager::LoadTexture("textures/powerup_increase.png", true, "powerup_increase");
-    ResourceManager::LoadTexture("textures/powerup_passthrough.png", true, "powerup_passthrough");
-    ResourceManager::LoadTexture("textures/powerup_speed.png", true, "powerup_speed");
-    ResourceManager::LoadTexture("textures/powerup_sticky.png", true, "powerup_sticky");
-    ResourceManager::LoadTexture("textures/powerup_dec_speed.png", true, "powerup_dec_speed");
-    ResourceManager::LoadTexture("textures/powerup_slowmo.png", true, "powerup_slowmo");
-    ResourceManager::LoadTexture("textures/powerup_death.png", true, "powerup_death");
-    ResourceManager::LoadTexture("textures/powerup_ghost.png", true, "powerup_ghost");
+    for (unsigned int type = 0; type < POWERUP_TYPES; ++type)
+    {
+        std::string name = POWERUP_TABLE[type].Texture;
+        PowerUpTextures[type] = ResourceManager::LoadTexture(("textures/" + name + ".png").c_str(), true, name);
+    }
     Particles = new ParticleGenerator(
             ResourceManager::GetShader("particle"),
             ResourceManager::GetTexture("particle"),
-            1000
+            PARTICLE_BUDGET
     );
+    Particles->Seed(this->Seed);
     Effects = new PostProcessor(ResourceManager::GetShader("effects"), this->Width, this->Height);
     // load levels
-    GameLevel one; one.Load("levels/one.lvl", this->Width, this->Height / 2);
-    GameLevel two; two.Load("levels/two.lvl", this->Width, this->Height / 2);
-    GameLevel three; three.Load("levels/three.lvl", this->Width, this->Height / 2);
-    GameLevel four; four.Load("levels/four.lvl", this->Width, this->Height / 2);
-    this->Levels.push_back(one);
-    this->Levels.push_back(two);
-    this->Levels.push_back(three);
-    this->Levels.push_back(four);
-    this->Level = 0;
-    glm::vec2 playerPos = glm::vec2(
-        this->Width / 2.0f - PLAYER_SIZE.x / 2.0f,
-        this->Height - PLAYER_SIZE.y
-    );
-    Player = new GameObject(playerPos, PLAYER_SIZE, ResourceManager::GetTexture("paddle"));
-    glm::vec2 ballPos = playerPos + glm::vec2(PLAYER_SIZE.x / 2.0f - BALL_RADIUS,
-        -BALL_RADIUS * 2.0f);
-    Ball = new BallObject(ballPos, BALL_RADIUS, INITIAL_BALL_VELOCITY,
-        ResourceManager::GetTexture("face"));
+    this->Sim.Seed(this->Seed);
+    this->Sim.LoadLevels();
     backgroundMusic = SoundEngine->play2D("audio/breakout.mp3", true, false, true, ESM_AUTO_DETECT, true);
     backgroundMusicRev = SoundEngine->play2D("audio/breakout-reverse.mp3", true, true, true, ESM_AUTO_DETECT, false);
     bkgMusicFXControl = backgroundMusic->getSoundEffectControl();
     Text = new TextRenderer(this->Width, this->Height);
     Text->Load("fonts/ocraext.ttf", 24);
-    this->State = GAME_MENU;
+    this->Sim.State = GAME_MENU;
 };
 
+void Game::Tick(float dt)
+{
+    this->PrevPlayerPosition = this->Sim.Player.Position;
+    this->PrevOpponentPosition = this->Sim.Opponent.Position;
+    this->PrevBallPositions = this->Sim.Balls.Positions;
+    this->TickDt = dt;
+    if (this->Session)
+        this->TickVersus();
+    else
+        this->ProcessInput(dt);
+    this->Update(dt);
+}
+
 void Game::ProcessInput(float dt)
 {
-    if (this->State == GAME_WIN)
-    {
-        if (this->Keys[GLFW_KEY_ENTER])
-        {
-            this->KeysProcessed[GLFW_KEY_ENTER] = true;
-            Effects->Chaos = false;
-            this->State = GAME_MENU;
-        }
-    }
-    if (this->State == GAME_ACTIVE){
-        float velocity = PLAYER_VELOCITY * dt;
-        // move playerboard
-        if (this->Keys[GLFW_KEY_A] or this->Keys[GLFW_KEY_LEFT])
-        {
-            if (Player->Position.x >= 0.0f)
-            {
-                Player->Position.x -= velocity;
-                if (Ball->Stuck)
-                    Ball->Position.x -= velocity;
-            }
-        }
-        if (this->Keys[GLFW_KEY_D] or this->Keys[GLFW_KEY_RIGHT])
-        {
-            if (Player->Position.x <= this->Width - Player->Size.x)
-            {
-                Player->Position.x += velocity;
-                if (Ball->Stuck)
-                    Ball->Position.x += velocity;
-            }
-        }
-        if (this->Keys[GLFW_KEY_SPACE])
-            Ball->Stuck = false;
-    }
+    unsigned int keys = 0;
+    if (this->Playback && !this->Playback->Done())
+        keys = this->Playback->Next();
+    else
+        keys = this->localKeys(PLAYER_ONE, dt);
+    if (this->Recording)
+        this->Recording->Record(keys);
+    this->Sim.ProcessKeys(dt, keys);
+}
 
-    if (this->State == GAME_MENU)
-    {
-        if (this->Keys[GLFW_KEY_ENTER] && !this->KeysProcessed[GLFW_KEY_ENTER])
-        {
-            this->State = GAME_ACTIVE;
-            this->KeysProcessed[GLFW_KEY_ENTER] = true;
-        }
-        if (this->Keys[GLFW_KEY_W] && !this->KeysProcessed[GLFW_KEY_W])
-        {
-            this->Level = (this->Level + 1) % 4;
-            this->KeysProcessed[GLFW_KEY_W] = true;
-        }
-        if (this->Keys[GLFW_KEY_S] && !this->KeysProcessed[GLFW_KEY_S])
-        {
-            if (this->Level > 0)
-                --this->Level;
-            else
-                this->Level = 3;
-            this->KeysProcessed[GLFW_KEY_S] = true;
-        }
-    }
+unsigned int Game::localKeys(unsigned int player, float dt)
+{
+    unsigned int keys = KeyboardKeys(this->Keys);
+    if (this->Pilot)
+        keys = (keys & ~(GAME_KEY_LEFT | GAME_KEY_RIGHT | GAME_KEY_LAUNCH)) | this->Pilot->Keys(this->Sim, player, dt);
+    return keys;
 }
 
-void Game::Update(float dt) {
-    if (this->State == GAME_ACTIVE && this->Levels[this->Level].IsCompleted())
-    {
-        this->ResetLevel();
-        this->ResetPlayer();
-        Effects->Chaos = true;
-        this->State = GAME_WIN;
-    }
-    if (this->State == GAME_ACTIVE || this->State == GAME_MENU){
-        Ball->Move(dt, this->Width);
-        this->DoCollisions();
-        Particles->Update(dt, *Ball, 2, glm::vec2(Ball->Radius / 2.0f));
-        if (Ball->Position.y >= this->Height)
-        {
-            --this->Lives;
-            if (this->Lives == 0)
-            {
-                this->ResetLevel();
-                this->State = GAME_MENU;
-            }
-            this->ResetPlayer();
-        }
-        UpdatePowerUps(dt);
-        if (ShakeTime > 0.0f)
-        {
-            ShakeTime -= dt;
-            if (ShakeTime <= 0.0f)
-                Effects->Shake = false;
-        }
-    }
+void Game::TickVersus()
+{
+    unsigned char packet[MAX_VERSUS_PACKET];
+    while (size_t size = this->Link->Receive(packet, sizeof(packet)))
+        this->Session->Receive(packet, size);
+    this->Session->Advance(this->localKeys(this->Session->LocalPlayer, this->Session->TickLength));
+    this->Link->Send(packet, this->Session->WritePacket(packet, sizeof(packet)));
+}
 
-    if (this->State == GAME_MENU)
-    {
-        Text->RenderText("Press ENTER to start", 250.0f, Height / 2, 1.0f);
-        Text->RenderText("Press W or S to select level", 245.0f, Height / 2 + 20.0f, 0.75f);
-    }
+void Game::Update(float dt) {
+    // the rollback session already stepped a versus game
+    if (!this->Session)
+        this->Sim.Update(dt);
+    if (this->Sim.State == GAME_ACTIVE || this->Sim.State == GAME_MENU)
+        Particles->Update(dt, this->Sim.Balls.Positions, this->Sim.Balls.Velocities, 2, glm::vec2(this->Sim.Balls.Radius / 2.0f));
+    Effects->Shake = this->Sim.Shake;
+    Effects->Confuse = this->Sim.Confuse;
+    Effects->Chaos = this->Sim.Chaos;
+    UpdateMusic(this->Sim);
 };
 
-void Game::Render() {
+void Game::QuickSave()
+{
+    if (this->Recording || this->Playback || this->Session)
+        return;
+    if (!this->SaveState)
+        this->SaveState.reset(new SimSnapshot());
+    if (!this->SaveState->Save(this->Sim))
+        this->SaveState.reset();
+}
+
+void Game::QuickLoad()
+{
+    if (this->Recording || this->Playback || this->Session || !this->SaveState)
+        return;
+    // what was queued belongs to the state left behind
+    if (this->SaveState->Restore(this->Sim))
+        this->Sim.Events.Clear();
+}
+
+void Game::ReloadLevels()
+{
+    if (!this->Watcher)
+        return;
+    // the watcher thread did the reading and parsing; patching only touches the cells that changed
+    std::vector<LevelWatcher::Change> changes;
+    if (!this->Watcher->TakeChanges(changes))
+        return;
+    for (const LevelWatcher::Change& change : changes)
+        std::cout << "Reloaded " << change.File << ": " << this->Sim.ReloadLevel(change.File, change.Tiles) << " cells changed" << std::endl;
+}
+
+void Game::HandleEvents()
+{
+    // one sound per kind of event, however many happened this frame
+    bool sounds[EVENT_TYPES] = { };
+    this->Sim.Events.Drain([&](const SimEvent& event) {
+        sounds[event.Type] = true;
+        if (event.Type == EVENT_BRICK_DESTROYED)
+            Particles->Burst(event.Position + this->Sim.Levels[this->Sim.Level].UnitSize / 2.0f, BRICK_BURST, BRICK_COLORS[event.Kind]);
+    });
+    if (sounds[EVENT_BRICK_DESTROYED])
+        SoundEngine->play2D("audio/bleep.mp3");
+    if (sounds[EVENT_SOLID_HIT])
+        SoundEngine->play2D("audio/solid.wav");
+    if (sounds[EVENT_PADDLE_HIT])
+        SoundEngine->play2D("audio/bleep.wav");
+    if (sounds[EVENT_POWERUP_COLLECTED])
+        SoundEngine->play2D("audio/powerup.wav");
+}
+
+void Game::Render(float alpha) {
         Effects->BeginRender();
         // draw background
         Texture2D sprite = ResourceManager::GetTexture("background");
@@ -220,20 +264,68 @@ void Game::Render() {
             glm::vec2(0.0f, 0.0f), glm::vec2(this->Width, this->Height), 0.0f
         );
         // draw level
-        this->Levels[this->Level].Draw(*Renderer);
-        Player->Draw(*Renderer);
+        const BrickStore& bricks = this->Sim.Levels[this->Sim.Level].Bricks;
+        Texture2D block = ResourceManager::GetTexture("block");
+        Texture2D blockSolid = ResourceManager::GetTexture("block_solid");
+        for (unsigned int i = 0; i < bricks.Size(); ++i)
+            if (!bricks.IsDestroyed(i))
+                Renderer->DrawSprite(bricks.Kinds[i] == BRICK_KIND_SOLID ? blockSolid : block,
+                    bricks.Positions[i], bricks.Sizes[i], 0.0f, bricks.Color(i));
+        // moving objects are drawn in between the last two ticks
+        float teleport = this->Width / 4.0f;
+        GameObject player = this->Sim.Player;
+        player.Position = Interpolate(this->PrevPlayerPosition, player.Position, alpha, teleport);
+        DrawObject(player, ResourceManager::GetTexture("paddle"));
+        if (this->Sim.Versus)
+        {
+            GameObject opponent = this->Sim.Opponent;
+            opponent.Position = Interpolate(this->PrevOpponentPosition, opponent.Position, alpha, teleport);
+            DrawObject(opponent, ResourceManager::GetTexture("paddle"));
+        }
         Particles->Draw();
-        Ball->Draw(*Renderer);
-        for (PowerUp &powerUp : this->PowerUps)
+        // balls never move a diameter in one tick; further means the slot now holds another ball
+        Texture2D face = ResourceManager::GetTexture("face");
+        for (unsigned int i = 0; i < this->Sim.Balls.Size(); ++i)
+        {
+            BallObject ball = this->Sim.Balls.Get(i);
+            if (i < this->PrevBallPositions.size())
+                ball.Position = Interpolate(this->PrevBallPositions[i], ball.Position, alpha, ball.Size.x);
+            DrawObject(ball, face);
+        }
+        for (const PowerUp &powerUp : this->Sim.PowerUps)
             if (!powerUp.Destroyed)
-                powerUp.Draw(*Renderer);
+            {   // powerups fall at a constant velocity, so step them back from the current tick
+                GameObject drawn = powerUp;
+                drawn.Position -= powerUp.Velocity * this->TickDt * (1.0f - alpha);
+                DrawObject(drawn, PowerUpTextures[powerUp.Type]);
+            }
         Effects->EndRender();
         Effects->Render(glfwGetTime());
-        std::stringstream ss; ss << this->Lives;
+        if (this->Sim.Versus)
+        {   // each player's lives and score next to their paddle
+            std::stringstream one, two;
+            one << "P1 Lives:" << this->Sim.Lives << " Score:" << this->Sim.Scores[PLAYER_ONE];
+            two << "P2 Lives:" << this->Sim.OpponentLives << " Score:" << this->Sim.Scores[PLAYER_TWO];
+            Text->RenderText(one.str(), 5.0f, this->Height - 50.0f, 1.0f);
+            Text->RenderText(two.str(), 5.0f, 25.0f, 1.0f);
+            if (this->Sim.State == GAME_WIN)
+            {
+                const char* result = this->Sim.Winner == PLAYER_ONE ? "Player 1 WON!!!" : this->Sim.Winner == PLAYER_TWO ? "Player 2 WON!!!" : "Draw!";
+                Text->RenderText(result, 290.0f, Height / 2 - 20.0f, 1.0f, glm::vec3(0.0f, 1.0f, 0.0f));
+                Text->RenderText("Press ESC to quit", 260.0f, Height / 2, 1.0f, glm::vec3(1.0f, 1.0f, 0.0f));
+            }
+            return;
+        }
+        std::stringstream ss; ss << this->Sim.Lives;
         Text->RenderText("Lives:" + ss.str(), 5.0f, 5.0f, 1.0f);
+        if (this->Sim.State == GAME_ACTIVE)
+        {
+            std::stringstream bricks; bricks << this->Sim.Levels[this->Sim.Level].Progress().Remaining;
+            Text->RenderText("Bricks:" + bricks.str(), this->Width - 160.0f, 5.0f, 1.0f);
+        }
 
 
-        if (this->State == GAME_WIN)
+        if (this->Sim.State == GAME_WIN)
         {
             Text->RenderText(
                     "You WON!!!", 320.0, Height / 2 - 20.0, 1.0, glm::vec3(0.0, 1.0, 0.0)
@@ -243,392 +335,10 @@ void Game::Render() {
             );
         }
 
-        if (this->State == GAME_MENU)
+        if (this->Sim.State == GAME_MENU)
         {
             Text->RenderText("Press ENTER to start", 250.0f, Height / 2, 1.0f);
             Text->RenderText("Press W or S to select level", 245.0f, Height / 2 + 20.0f, 0.75f);
         }
 
 };
-
-
-void Game::ResetLevel() {
-    this->Lives = 3;
-    switch (this->Level)
-    {
-    case 0:
-        this->Levels[0].Load("levels/one.lvl", this->Width, this->Height / 2);
-        break;
-    case 1:
-        this->Levels[1].Load("levels/two.lvl", this->Width, this->Height / 2);
-    case 2:
-        this->Levels[2].Load("levels/three.lvl", this->Width, this->Height / 2);
-        break;
-    case 3:
-        this->Levels[3].Load("levels/four.lvl", this->Width, this->Height / 2);
-    }
-}
-
-void Game::ResetPlayer() {
-    Player->Size = PLAYER_SIZE;
-    Player->Position = glm::vec2(this->Width / 2.0f - PLAYER_SIZE.x / 2.0f, this->Height - PLAYER_SIZE.y);
-    Ball->Reset(Player->Position + glm::vec2(PLAYER_SIZE.x / 2.0f - BALL_RADIUS, -(BALL_RADIUS * 2.0f)), INITIAL_BALL_VELOCITY);
-}
-
-bool CheckCollision(GameObject &one, GameObject &two) // AABB - AABB collision
-{
-    // collision x-axis?
-    bool collisionX = one.Position.x + one.Size.x >= two.Position.x &&
-                      two.Position.x + two.Size.x >= one.Position.x;
-    // collision y-axis?
-    bool collisionY = one.Position.y + one.Size.y >= two.Position.y &&
-                      two.Position.y + two.Size.y >= one.Position.y;
-    // collision only if on both axes
-    return collisionX && collisionY;
-}
-
-Collision CheckCollision(BallObject& one, GameObject& two) // AABB - AABB collision
-{
-    // get center point circle first 
-    glm::vec2 center(one.Position + one.Radius);
-    // calculate AABB info (center, half-extents)
-    glm::vec2 aabb_half_extents(two.Size.x / 2.0f, two.Size.y / 2.0f);
-    glm::vec2 aabb_center(
-        two.Position.x + aabb_half_extents.x,
-        two.Position.y + aabb_half_extents.y
-    );
-    // get difference vector between both centers
-    glm::vec2 difference = center - aabb_center;
-    glm::vec2 clamped = glm::clamp(difference, -aabb_half_extents, aabb_half_extents);
-    // add clamped value to AABB_center and we get the value of box closest to circle
-    glm::vec2 closest = aabb_center + clamped;
-    // retrieve vector between center circle and closest point AABB and check if length <= radius
-    difference = closest - center;
-    if (glm::length(difference) <= one.Radius)
-        return std::make_tuple(true, VectorDirection(difference), difference);
-    else
-        return std::make_tuple(false, UP, glm::vec2(0.0f, 0.0f));
-}
-
-bool ShouldSpawn(unsigned int chance)
-{
-    unsigned int random = rand() % chance;
-    return random == 0;
-}
-void Game::SpawnPowerUps(GameObject &block)
-{
-    if (ShouldSpawn(75)) // 1 in 75 chance
-        this->PowerUps.push_back(PowerUp("speed", glm::vec3(0.5f, 0.5f, 1.0f), 0.0f, block.Position, ResourceManager::GetTexture("powerup_speed")));
-    else if (ShouldSpawn(75))
-        this->PowerUps.push_back(PowerUp("sticky", glm::vec3(1.0f, 0.5f, 1.0f), 20.0f, block.Position, ResourceManager::GetTexture("powerup_sticky")));
-    else if (ShouldSpawn(75))
-        this->PowerUps.push_back(PowerUp("pass-through", glm::vec3(0.5f, 1.0f, 0.5f), 10.0f, block.Position, ResourceManager::GetTexture("powerup_passthrough")));
-    else if (ShouldSpawn(75))
-        this->PowerUps.push_back(PowerUp("pad-size-increase", glm::vec3(1.0f, 0.6f, 0.4), 0.0f, block.Position, ResourceManager::GetTexture("powerup_increase")));
-    else if (ShouldSpawn(75))
-        this->PowerUps.push_back(PowerUp("dec_speed", glm::vec3(1.0f, 0.5f, 0.8), 0.0f, block.Position, ResourceManager::GetTexture("powerup_dec_speed")));
-    else if (ShouldSpawn(75))
-        this->PowerUps.push_back(PowerUp("slowmo", glm::vec3(0.0f, 0.6f, 1.0), 20.0f, block.Position, ResourceManager::GetTexture("powerup_slowmo")));
-    else if (ShouldSpawn(75))
-        this->PowerUps.push_back(PowerUp("ghost", glm::vec3(0.5f, 0.5f, 0.5), 20.0f, block.Position, ResourceManager::GetTexture("powerup_ghost")));
-    else if (ShouldSpawn(25)) // Negative powerups should spawn more often
-        this->PowerUps.push_back(PowerUp("confuse", glm::vec3(1.0f, 0.3f, 0.3f), 15.0f, block.Position, ResourceManager::GetTexture("powerup_confuse")));
-    else if (ShouldSpawn(25))
-        this->PowerUps.push_back(PowerUp("chaos", glm::vec3(0.9f, 0.25f, 0.25f), 15.0f, block.Position, ResourceManager::GetTexture("powerup_chaos")));
-    else if (ShouldSpawn(75))
-        this->PowerUps.push_back(PowerUp("death", glm::vec3(1.0f, 0.1f, 0.1f), 0.0f, block.Position, ResourceManager::GetTexture("powerup_death")));
-}
-
-bool IsOtherPowerUpActive(std::vector<PowerUp>& powerUps, std::string type)
-{
-    for (const PowerUp& powerUp : powerUps)
-    {
-        if (powerUp.Activated)
-            if (powerUp.Type == type)
-                return true;
-    }
-    return false;
-}
-
-void Game::ActivatePowerUp(PowerUp &powerUp)
-{
-    if (powerUp.Type == "speed")
-    {
-        Ball->Velocity *= 1.2;
-    }
-    else if (powerUp.Type == "sticky")
-    {
-        Ball->Sticky = true;
-        Player->Color = glm::vec3(1.0f, 0.5f, 1.0f);
-    }
-    else if (powerUp.Type == "pass-through")
-    {
-        Ball->PassThrough = true;
-        if (IsOtherPowerUpActive(this->PowerUps, "slowmo") && IsOtherPowerUpActive(this->PowerUps, "ghost"))
-            Ball->Color = glm::vec3(0.5f, 0.6f, 0.7f);
-        else if (IsOtherPowerUpActive(this->PowerUps, "slowmo"))
-            Ball->Color = glm::vec3(0.5f, 0.5f, 0.7f);
-        else if (IsOtherPowerUpActive(this->PowerUps, "ghost"))
-            Ball->Color = glm::vec3(0.7f, 0.5f, 0.5f);
-        else
-            Ball->Color = glm::vec3(1.0f, 0.5f, 0.5f);
-    }
-    else if (powerUp.Type == "pad-size-increase")
-    {
-        Player->Size.x += 50;
-    }
-    else if (powerUp.Type == "confuse")
-    {
-        if (!Effects->Chaos) {
-            Effects->Confuse = true; // only activate if chaos wasn't already active
-            backgroundMusic->setIsPaused(true);
-            backgroundMusicRev->setPlayPosition(backgroundMusic->getPlayLength() - backgroundMusic->getPlayPosition());
-            backgroundMusicRev->setIsPaused(false);
-        }
-    }
-    else if (powerUp.Type == "chaos")
-    {
-        if (!Effects->Confuse) {
-            Effects->Chaos = true;
-            if (bkgMusicFXControl)
-                bkgMusicFXControl->enableDistortionSoundEffect();
-            else
-                std::cout << "This device or sound does not support sound effects.\n";
-        }
-    }
-    else if (powerUp.Type == "dec_speed")
-    {
-        Ball->Velocity *= 0.8;
-    }
-    else if (powerUp.Type == "ghost")
-    {
-        Ball->Ghost = true;
-        if (IsOtherPowerUpActive(this->PowerUps, "slowmo") && IsOtherPowerUpActive(this->PowerUps, "pass-through"))
-            Ball->Color = glm::vec3(0.5f, 0.6f, 0.7f);
-        else if (IsOtherPowerUpActive(this->PowerUps, "slowmo"))
-            Ball->Color = glm::vec3(0.2f, 0.6f, 0.7f);
-        else if (IsOtherPowerUpActive(this->PowerUps, "pass-through"))
-            Ball->Color = glm::vec3(0.7f, 0.5f, 0.5f);
-        else
-            Ball->Color = glm::vec3(0.5f, 0.5f, 0.5f);
-    }
-    else if (powerUp.Type == "slowmo")
-    {
-        if (!IsOtherPowerUpActive(this->PowerUps, "slowmo")) {
-            Ball->oldVelocity = Ball->Velocity;
-            Ball->Velocity.y = INITIAL_BALL_VELOCITY.y * 0.3f;
-            if (Ball->oldVelocity.y / abs(Ball->oldVelocity.y) != (Ball->Velocity.y / abs(Ball->Velocity.y)))
-                Ball->Velocity.y *= -1;
-            if (IsOtherPowerUpActive(this->PowerUps, "ghost") && IsOtherPowerUpActive(this->PowerUps, "pass-through"))
-                Ball->Color = glm::vec3(0.5f, 0.6f, 0.7f);
-            else if (IsOtherPowerUpActive(this->PowerUps, "ghost"))
-                Ball->Color = glm::vec3(0.2f, 0.6f, 0.7f);
-            else if (IsOtherPowerUpActive(this->PowerUps, "pass-through"))
-                Ball->Color = glm::vec3(0.5f, 0.5f, 0.7f);
-            else
-                Ball->Color = glm::vec3(0.0f, 0.6f, 1.0f);
-            backgroundMusic->setPlaybackSpeed(0.5f);
-        }
-    }
-    else if (powerUp.Type == "death")
-    {
-        --this->Lives;
-        if (this->Lives == 0)
-        {
-            this->ResetLevel();
-            this->State = GAME_MENU;
-        }
-        this->ResetPlayer();
-    }
-}
-
-
-
-
-void Game::UpdatePowerUps(float dt)
-{
-    for (PowerUp &powerUp : this->PowerUps)
-    {
-        powerUp.Position += powerUp.Velocity * dt;
-        if (powerUp.Activated)
-        {
-            powerUp.Duration -= dt;
-
-            if (powerUp.Duration <= 0.0f)
-            {
-                // remove powerup from list (will later be removed)
-                powerUp.Activated = false;
-                // deactivate effects
-                if (powerUp.Type == "sticky")
-                {
-                    if (!IsOtherPowerUpActive(this->PowerUps, "sticky"))
-                    {	// only reset if no other PowerUp of type sticky is active
-                        Ball->Sticky = false;
-                        Player->Color = glm::vec3(1.0f);
-                    }
-                }
-                else if (powerUp.Type == "pass-through")
-                {
-                    if (!IsOtherPowerUpActive(this->PowerUps, "pass-through"))
-                    {	// only reset if no other PowerUp of type pass-through is active
-                        Ball->PassThrough = false;
-                        Ball->Color = glm::vec3(1.0f);
-                    }
-                }
-                else if (powerUp.Type == "ghost")
-                {
-                    if (!IsOtherPowerUpActive(this->PowerUps, "ghost"))
-                    {	// only reset if no other PowerUp of type pass-through is active
-                        Ball->Ghost = false;
-                    }
-                }
-                else if (powerUp.Type == "confuse")
-                {
-                    if (!IsOtherPowerUpActive(this->PowerUps, "confuse"))
-                    {	// only reset if no other PowerUp of type confuse is active
-                        Effects->Confuse = false;
-                        backgroundMusicRev->setIsPaused(true);
-                        backgroundMusic->setPlayPosition(backgroundMusicRev->getPlayLength() - backgroundMusicRev->getPlayPosition());
-                        backgroundMusic->setIsPaused(false);
-                    }
-                }
-                else if (powerUp.Type == "chaos")
-                {
-                    if (!IsOtherPowerUpActive(this->PowerUps, "chaos"))
-                    {	// only reset if no other PowerUp of type chaos is active
-                        Effects->Chaos = false;
-                        if (bkgMusicFXControl)
-                            bkgMusicFXControl->disableDistortionSoundEffect();
-                        else
-                            std::cout << "This device or sound does not support sound effects.\n";
-                    }
-                }
-                else if (powerUp.Type == "slowmo")
-                {
-                    if (!IsOtherPowerUpActive(this->PowerUps, "slowmo"))
-                    {	// only reset if no other PowerUp of type chaos is active
-                        bool isNegative = false;
-                        if (Ball->oldVelocity.y / abs(Ball->oldVelocity.y) != (Ball->Velocity.y / abs(Ball->Velocity.y)))
-                            isNegative = true;
-                        Ball->Velocity.y = Ball->oldVelocity.y;
-                        Ball->Color = glm::vec3(1.0f);
-                        if (isNegative)
-                            Ball->Velocity.y *= -1;
-                        backgroundMusic->setPlaybackSpeed(1.0f);
-                    }
-                }
-            }
-        }
-    }
-    this->PowerUps.erase(std::remove_if(this->PowerUps.begin(), this->PowerUps.end(),
-                                        [](const PowerUp &powerUp) { return powerUp.Destroyed && !powerUp.Activated; }
-    ), this->PowerUps.end());
-}
-
-
-void Game::DoCollisions() {
-    for (GameObject& box : this->Levels[this->Level].Bricks) {
-        if (!box.Destroyed) {
-            Collision collision = CheckCollision(*Ball, box);
-            if (std::get<0>(collision)) // if collision is true
-            {
-                // destroy block if not solid
-                if (!box.IsSolid) {
-                    box.Destroyed = true;
-                    this->SpawnPowerUps(box);
-                    SoundEngine->play2D("audio/bleep.mp3");
-                }
-                else if(!Ball->Ghost) {
-                    ShakeTime = 0.05f;
-                    Effects->Shake = true;
-                    SoundEngine->play2D("audio/solid.wav");
-                }
-                // collision resolution
-                Direction dir = std::get<1>(collision);
-                glm::vec2 diff_vector = std::get<2>(collision);
-                if (!(Ball->PassThrough && !box.IsSolid) && !(Ball->Ghost && box.IsSolid )){
-                    if (dir == LEFT || dir == RIGHT) // horizontal collision
-                    {
-                        Ball->Velocity.x = -Ball->Velocity.x; // reverse horizontal velocity
-                        // relocate
-                        float penetration = Ball->Radius - std::abs(diff_vector.x);
-                        if (dir == LEFT)
-                            Ball->Position.x += penetration; // move ball to right
-                        else
-                            Ball->Position.x -= penetration; // move ball to left;
-                    }
-                    else // vertical collision
-                    {
-                        Ball->Velocity.y = -Ball->Velocity.y; // reverse vertical velocity
-                        // relocate
-                        float penetration = Ball->Radius - std::abs(diff_vector.y);
-                        if (dir == UP)
-                            Ball->Position.y -= penetration; // move ball back up
-                        else
-                            Ball->Position.y += penetration; // move ball back down
-                    }
-                }
-            }
-        }
-    }
-    for (PowerUp &powerUp : this->PowerUps)
-    {
-        if (!powerUp.Destroyed)
-        {
-            if (powerUp.Position.y >= this->Height)
-                powerUp.Destroyed = true;
-            if (CheckCollision(*Player, powerUp))
-            {	// collided with player, now activate powerup
-                ActivatePowerUp(powerUp);
-                SoundEngine->play2D("audio/powerup.wav");
-                powerUp.Destroyed = true;
-                powerUp.Activated = true;
-            }
-        }
-    }
-    Collision result = CheckCollision(*Ball, *Player);
-    if (!Ball->Stuck && std::get<0>(result))
-    {
-        // check where it hit the board, and change velocity based on where it hit the board
-        float centerBoard = Player->Position.x + Player->Size.x / 2.0f;
-        float distance = (Ball->Position.x + Ball->Radius) - centerBoard;
-        float percentage = distance / (Player->Size.x / 2.0f);
-        // then move accordingly
-        float strength = 2.0f;
-        glm::vec2 oldVelocity = Ball->Velocity;
-        Ball->Velocity.x = INITIAL_BALL_VELOCITY.x * percentage * strength;
-        //Ball->Velocity.y = -Ball->Velocity.y;
-        Ball->Velocity = glm::normalize(Ball->Velocity) * glm::length(oldVelocity); // keep speed consistent over both axes (multiply by length of old velocity, so total strength is not changed)
-        // fix sticky paddle
-        Ball->Velocity.y = -1.0f * abs(Ball->Velocity.y);
-
-        // if Sticky powerup is activated, also stick ball to paddle once new velocity vectors were calculated
-        Ball->Stuck = Ball->Sticky;
-        SoundEngine->play2D("audio/bleep.wav");
-    }
-}
-
-
-
-
-Direction VectorDirection(glm::vec2 target)
-{
-    glm::vec2 compass[] = {
-        glm::vec2(0.0f, 1.0f),	// up
-        glm::vec2(1.0f, 0.0f),	// right
-        glm::vec2(0.0f, -1.0f),	// down
-        glm::vec2(-1.0f, 0.0f)	// left
-    };
-    float max = 0.0f;
-    unsigned int best_match = -1;
-    for (unsigned int i = 0; i < 4; i++)
-    {
-        float dot_product = glm::dot(glm::normalize(target), compass[i]);
-        if (dot_product > max)
-        {
-            max = dot_product;
-            best_match = i;
-        }
-    }
-    return (Direction)best_match;
-}
\ No newline at end of file
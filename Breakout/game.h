@@ -3,49 +3,63 @@
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
-#include <tuple>
-#include "game_level.h"
-#include "powerup.h"
-
-enum GameState {
-	GAME_ACTIVE,
-	GAME_MENU,
-	GAME_WIN
-};
-
-enum Direction {
-	UP,
-	RIGHT,
-	DOWN,
-	LEFT
-};
-
-typedef std::tuple<bool, Direction, glm::vec2> Collision;
-
-Direction VectorDirection(glm::vec2 target);
+#include <memory>
+#include <vector>
+#include "simulation.h"
+#include "input_recording.h"
+#include "snapshot.h"
+#include "rollback_session.h"
+#include "udp_link.h"
+#include "controller.h"
+#include "level_watcher.h"
 
+// Game is the interactive client of a Simulation: it turns keyboard
+// state into SimInput, handles the menu, and renders the simulation
+// state with sprites, particles, text and audio.
 class Game {
 public:
-	GameState State;
 	bool Keys[1024];
 	unsigned int Width, Height;
-    std::vector<PowerUp>  PowerUps;
-	std::vector<GameLevel>  Levels;
-	unsigned int Level;
-    unsigned int Lives;
-    bool KeysProcessed[1024];
+	Simulation Sim;
+	// seed of the gameplay and cosmetic random streams, applied by Init
+	uint64_t Seed;
+	// when set, every tick's keys are appended to Recording, or taken from Playback instead of the keyboard; not owned
+	InputRecording* Recording;
+	InputPlayback* Playback;
+	// when set, this is one side of a networked versus game: keys go through the session, packets through the link; not owned
+	RollbackSession* Session;
+	UdpLink* Link;
+	// when set, drives the local paddle instead of the keyboard, which still works the menu; not owned
+	Controller* Pilot;
+	// when set, level files that change on disk are patched into the running game; not owned
+	LevelWatcher* Watcher;
+	// quick save slot, empty until the first QuickSave
+	std::unique_ptr<SimSnapshot> SaveState;
+	// positions before the last tick, used to interpolate rendering between ticks
+	glm::vec2 PrevPlayerPosition, PrevOpponentPosition;
+	std::vector<glm::vec2> PrevBallPositions;
+	float TickDt;
 	Game(unsigned int width, unsigned int height);
 	~Game();
 	void Init();
+	// advances the game by one tick of dt seconds
+	void Tick(float dt);
 	void ProcessInput(float dt);
+	// exchanges keys with the peer and lets the session run the versus game's next tick
+	void TickVersus();
 	void Update(float dt);
-	void Render();
-	void DoCollisions();
-	void ResetLevel();
-	void ResetPlayer();
-    void SpawnPowerUps(GameObject &block);
-    void UpdatePowerUps(float dt);
-	void ActivatePowerUp(PowerUp& powerUp);
+	// saves the game into, or puts it back from, the quick save slot; not while recording, replaying or in versus
+	void QuickSave();
+	void QuickLoad();
+	// plays sounds and particle bursts for the events of the ticks since the last frame
+	void HandleEvents();
+	// patches the level files the Watcher saw change into the levels, once a frame
+	void ReloadLevels();
+	// renders the game alpha (0..1) of the way between the previous and the current tick
+	void Render(float alpha = 1.0f);
+private:
+	// keys of the local player: the keyboard's, with the paddle taken over by the Pilot if there is one
+	unsigned int localKeys(unsigned int player, float dt);
 };
 
-#endif
\ No newline at end of file
+#endif
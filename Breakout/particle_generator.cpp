@@ -1,18 +1,28 @@
 #include "particle_generator.h"
 
+#include <cmath>
+
 ParticleGenerator::ParticleGenerator(Shader shader, Texture2D texture, unsigned int amount)
-        : shader(shader), texture(texture), amount(amount)
+        : amount(amount), lastUsedParticle(0), random(0, RNG_STREAM_COSMETIC), shader(shader), texture(texture)
 {
     this->init();
 }
 
-void ParticleGenerator::Update(float dt, GameObject &object, unsigned int newParticles, glm::vec2 offset)
+void ParticleGenerator::Seed(uint64_t seed)
+{
+    this->random.Seed(seed, RNG_STREAM_COSMETIC);
+}
+
+void ParticleGenerator::Update(float dt, const std::vector<glm::vec2> &positions, const std::vector<glm::vec2> &velocities, unsigned int newParticles, glm::vec2 offset)
 {
     // add new particles
-    for (unsigned int i = 0; i < newParticles; ++i)
+    for (unsigned int emitter = 0; emitter < positions.size(); ++emitter)
     {
-        int unusedParticle = this->firstUnusedParticle();
-        this->respawnParticle(this->particles[unusedParticle], object, offset);
+        for (unsigned int i = 0; i < newParticles; ++i)
+        {
+            int unusedParticle = this->firstUnusedParticle();
+            this->respawnParticle(this->particles[unusedParticle], positions[emitter], velocities[emitter], offset);
+        }
     }
     // update all particles
     for (unsigned int i = 0; i < this->amount; ++i)
@@ -27,24 +37,51 @@ void ParticleGenerator::Update(float dt, GameObject &object, unsigned int newPar
     }
 }
 
+void ParticleGenerator::Burst(glm::vec2 position, unsigned int count, glm::vec3 color)
+{
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        Particle &particle = this->particles[this->firstUnusedParticle()];
+        // particles move against their velocity (see Update), the direction doesn't matter here
+        float angle = this->random.Below(360) * 3.14159265f / 180.0f;
+        float speed = 40.0f + this->random.Below(80);
+        particle.Position = position;
+        particle.Velocity = glm::vec2(std::cos(angle), std::sin(angle)) * speed;
+        particle.Color = glm::vec4(color, 1.0f);
+        particle.Life = 0.4f;
+    }
+}
+
 // render all particles
 void ParticleGenerator::Draw()
 {
     // use additive blending to give it a 'glow' effect
     glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-    this->shader.Use();
-    for (Particle particle : this->particles)
+    // gather the live particles into the instance buffer
+    this->instances.clear();
+    for (const Particle &particle : this->particles)
     {
         if (particle.Life > 0.0f)
         {
-            this->shader.SetVector2f("offset", particle.Position);
-            this->shader.SetVector4f("color", particle.Color);
-            this->texture.Bind();
-            glBindVertexArray(this->VAO);
-            glDrawArrays(GL_TRIANGLES, 0, 6);
-            glBindVertexArray(0);
+            this->instances.push_back(particle.Position.x);
+            this->instances.push_back(particle.Position.y);
+            this->instances.push_back(particle.Color.r);
+            this->instances.push_back(particle.Color.g);
+            this->instances.push_back(particle.Color.b);
+            this->instances.push_back(particle.Color.a);
         }
     }
+    if (!this->instances.empty())
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, this->instanceVBO);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, this->instances.size() * sizeof(float), this->instances.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        this->shader.Use();
+        this->texture.Bind();
+        glBindVertexArray(this->VAO);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 6, static_cast<GLsizei>(this->instances.size() / 6));
+        glBindVertexArray(0);
+    }
     // don't forget to reset to default blending mode
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 }
@@ -71,42 +108,51 @@ void ParticleGenerator::init()
     // set mesh attributes
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    // per particle attributes: offset and color, advanced once per instance
+    glGenBuffers(1, &this->instanceVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, this->instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, this->amount * 6 * sizeof(float), nullptr, GL_STREAM_DRAW);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(2 * sizeof(float)));
+    glVertexAttribDivisor(2, 1);
     glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     // create this->amount default particle instances
     for (unsigned int i = 0; i < this->amount; ++i)
         this->particles.push_back(Particle());
 }
 
-// stores the index of the last particle used (for quick access to next dead particle)
-unsigned int lastUsedParticle = 0;
 unsigned int ParticleGenerator::firstUnusedParticle()
 {
     // first search from last used particle, this will usually return almost instantly
-    for (unsigned int i = lastUsedParticle; i < this->amount; ++i){
+    for (unsigned int i = this->lastUsedParticle; i < this->amount; ++i){
         if (this->particles[i].Life <= 0.0f){
-            lastUsedParticle = i;
+            this->lastUsedParticle = i;
             return i;
         }
     }
     // otherwise, do a linear search
-    for (unsigned int i = 0; i < lastUsedParticle; ++i){
+    for (unsigned int i = 0; i < this->lastUsedParticle; ++i){
         if (this->particles[i].Life <= 0.0f){
-            lastUsedParticle = i;
+            this->lastUsedParticle = i;
             return i;
         }
     }
-    // all particles are taken, override the first one (note that if it repeatedly hits this case, more particles should be reserved)
-    lastUsedParticle = 0;
-    return 0;
+    // all particles are taken, override the one after the last used, which is usually the oldest
+    this->lastUsedParticle = (this->lastUsedParticle + 1) % this->amount;
+    return this->lastUsedParticle;
 }
 
-void ParticleGenerator::respawnParticle(Particle &particle, GameObject &object, glm::vec2 offset)
+void ParticleGenerator::respawnParticle(Particle &particle, glm::vec2 position, glm::vec2 velocity, glm::vec2 offset)
 {
-    float random = ((rand() % 100) - 50) / 10.0f;
-    float rColor = 0.5f + ((rand() % 100) / 100.0f);
-    particle.Position = object.Position + random + offset;
+    float random = (static_cast<int>(this->random.Below(100)) - 50) / 10.0f;
+    float rColor = 0.5f + (this->random.Below(100) / 100.0f);
+    particle.Position = position + random + offset;
     particle.Color = glm::vec4(rColor, rColor, rColor, 1.0f);
     particle.Life = 1.0f;
-    particle.Velocity = object.Velocity * 0.1f;
+    particle.Velocity = velocity * 0.1f;
 }
\ No newline at end of file
@@ -8,6 +8,8 @@
 #include <glm/glm.hpp>
 #include <vector>
 #include "game_object.h"
+#include "pcg32.h"
+#include "shader.h"
 #include "texture.h"
 
 struct Particle {
@@ -18,20 +20,32 @@ struct Particle {
     Particle() : Position(0.0f), Velocity(0.0f), Color(1.0f), Life(0.0f) { }
 };
 
+// ParticleGenerator keeps a fixed budget of particles that trail behind
+// any number of emitters. All live particles are drawn with a single
+// instanced draw call; when more are emitted than the budget holds, the
+// oldest ones are recycled first so trails shorten instead of vanishing.
 class ParticleGenerator{
 public:
     ParticleGenerator(Shader shader, Texture2D texture, unsigned int amount);
-    void Update(float dt, GameObject &object, unsigned int newParticles, glm::vec2 offset = glm::vec2(0.0f, 0.0f));
+    // emits newParticles behind every emitter, given as parallel position and velocity arrays, and ages all particles
+    void Update(float dt, const std::vector<glm::vec2> &positions, const std::vector<glm::vec2> &velocities, unsigned int newParticles, glm::vec2 offset = glm::vec2(0.0f, 0.0f));
+    // throws count particles of the given color out of position in all directions
+    void Burst(glm::vec2 position, unsigned int count, glm::vec3 color);
     void Draw();
+    // restarts the cosmetic random stream the particles are scattered with
+    void Seed(uint64_t seed);
 private:
     std::vector<Particle> particles;
+    std::vector<float> instances; // offset and color of every live particle, uploaded on Draw
     unsigned int amount;
+    unsigned int lastUsedParticle; // index of the last particle used, where the search for a dead one starts
+    Pcg32 random;
     Shader shader;
     Texture2D texture;
-    unsigned int VAO;
+    unsigned int VAO, instanceVBO;
     void init();
     unsigned int firstUnusedParticle();
-    void respawnParticle(Particle &particle, GameObject &object, glm::vec2 offset = glm::vec2(0.0f, 0.0f));
+    void respawnParticle(Particle &particle, glm::vec2 position, glm::vec2 velocity, glm::vec2 offset = glm::vec2(0.0f, 0.0f));
 };
 
 #endif //BREAKOUT_PARTICLE_GENERATOR_H
@@ -3,8 +3,15 @@
 
 #include "game.h"
 #include "resource_manager.h"
+#include "fixed_timestep.h"
+#include "autopilot.h"
 
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <random>
+#include <string>
 
 // GLFW function declarations
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
@@ -14,11 +21,159 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 const unsigned int SCREEN_WIDTH = 800;
 // The height of the screen
 const unsigned int SCREEN_HEIGHT = 600;
+// Default number of simulation ticks per second
+const double TICK_RATE = 120.0;
+// Maximum number of ticks simulated to catch up after a slow frame
+const unsigned int MAX_CATCH_UP_STEPS = 8;
 
 Game Breakout(SCREEN_WIDTH, SCREEN_HEIGHT);
 
 int main(int argc, char* argv[])
 {
+    // command line options
+    // --------------------
+    // --tick-rate <hz> sets the fixed simulation rate; 0 steps the game once per frame with the raw frame time
+    // --discrete-collisions uses the old move-then-overlap collision test instead of swept collisions
+    // --balls <n> serves n balls at once (stress mode)
+    // --seed <n> seeds the game's random streams; by default every run gets a fresh seed
+    // --record <file> saves the session's keys with everything needed to replay it
+    // --replay <file> plays a recorded session back instead of reading the keyboard
+    // --autopilot lets the trajectory predicting autopilot play the paddle
+    // --versus <1|2> plays a versus game as that player against another instance; needs --port and --peer
+    // --port <n> is the local UDP port of a versus game, --peer <ip:port> where the other player listens
+    // --level <n> is the level of a versus game; both players must pick the same level, seed and tick rate
+    // --input-delay <ticks> applies the local keys that many ticks later, hiding latency without rollbacks
+    // --latency <ms>, --jitter <ms> and --loss <fraction> fake a bad network on the packets sent
+    // --endless plays an endless level of rows made up from the seed, scrolling towards the paddle
+    // --stream <file> plays a compiled level file as a scrolling level, its last line first
+    // --scroll <px/s> is how fast a streamed level scrolls down
+    // --watch-levels patches level files into the running game as they are saved
+    double tickRate = TICK_RATE;
+    Breakout.Seed = std::random_device()();
+    const char* recordFile = nullptr;
+    const char* replayFile = nullptr;
+    unsigned int versusPlayer = 0, versusLevel = 0, inputDelay = 2;
+    unsigned short port = 0, peerPort = 0;
+    std::string peerHost;
+    bool seeded = false;
+    bool endless = false;
+    const char* streamFile = nullptr;
+    float scrollSpeed = 8.0f;
+    bool watchLevels = false;
+    UdpLink link;
+    Autopilot autopilot;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc)
+            tickRate = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--discrete-collisions") == 0)
+            Breakout.Sim.Collisions = COLLISION_DISCRETE;
+        else if (std::strcmp(argv[i], "--balls") == 0 && i + 1 < argc)
+            Breakout.Sim.ServeBalls = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            Breakout.Seed = std::strtoull(argv[++i], nullptr, 10);
+            seeded = true;
+        }
+        else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            recordFile = argv[++i];
+        else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+            replayFile = argv[++i];
+        else if (std::strcmp(argv[i], "--autopilot") == 0)
+            Breakout.Pilot = &autopilot;
+        else if (std::strcmp(argv[i], "--versus") == 0 && i + 1 < argc)
+            versusPlayer = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--port") == 0 && i + 1 < argc)
+            port = static_cast<unsigned short>(std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--peer") == 0 && i + 1 < argc)
+        {
+            std::string peer = argv[++i];
+            size_t colon = peer.rfind(':');
+            peerHost = peer.substr(0, colon);
+            peerPort = colon == std::string::npos ? 0 : static_cast<unsigned short>(std::atoi(peer.c_str() + colon + 1));
+        }
+        else if (std::strcmp(argv[i], "--level") == 0 && i + 1 < argc)
+            versusLevel = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--input-delay") == 0 && i + 1 < argc)
+            inputDelay = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--latency") == 0 && i + 1 < argc)
+            link.Conditions.LatencyMs = static_cast<float>(std::atof(argv[++i]));
+        else if (std::strcmp(argv[i], "--jitter") == 0 && i + 1 < argc)
+            link.Conditions.JitterMs = static_cast<float>(std::atof(argv[++i]));
+        else if (std::strcmp(argv[i], "--loss") == 0 && i + 1 < argc)
+            link.Conditions.Loss = static_cast<float>(std::atof(argv[++i]));
+        else if (std::strcmp(argv[i], "--endless") == 0)
+            endless = true;
+        else if (std::strcmp(argv[i], "--stream") == 0 && i + 1 < argc)
+            streamFile = argv[++i];
+        else if (std::strcmp(argv[i], "--scroll") == 0 && i + 1 < argc)
+            scrollSpeed = static_cast<float>(std::atof(argv[++i]));
+        else if (std::strcmp(argv[i], "--watch-levels") == 0)
+            watchLevels = true;
+    }
+    InputRecording recording;
+    if (replayFile)
+    {   // the replay decides everything that changes how the game plays out
+        if (!recording.Load(replayFile))
+        {
+            std::cout << "Failed to load recording " << replayFile << std::endl;
+            return -1;
+        }
+        Breakout.Seed = recording.Seed;
+        Breakout.Sim.ServeBalls = recording.ServeBalls;
+        Breakout.Sim.Collisions = recording.Collisions;
+        tickRate = recording.TickRate;
+        recordFile = nullptr;
+    }
+    else if (recordFile && tickRate <= 0.0)
+    {
+        std::cout << "Recording needs a fixed tick rate" << std::endl;
+        return -1;
+    }
+    InputPlayback playback(recording);
+    if (watchLevels && (versusPlayer || replayFile || recordFile))
+    {
+        std::cout << "Changing levels would break versus games, recordings and replays; --watch-levels can't be used with them" << std::endl;
+        return -1;
+    }
+    std::shared_ptr<const ChunkSource> stream;
+    if (endless || streamFile)
+    {
+        if (versusPlayer || replayFile || recordFile)
+        {
+            std::cout << "Streamed levels can't be played in versus, recorded or replayed" << std::endl;
+            return -1;
+        }
+        if (streamFile)
+        {
+            std::shared_ptr<CompiledLevelRows> rows = std::make_shared<CompiledLevelRows>(streamFile);
+            if (!rows->IsOpen() || rows->Columns() == 0)
+            {
+                std::cout << "Failed to stream " << streamFile << "; text levels have to be compiled first" << std::endl;
+                return -1;
+            }
+            stream = rows;
+        }
+        else
+            stream = std::make_shared<GeneratedRows>(15, Breakout.Seed);
+    }
+    if (versusPlayer)
+    {
+        if (versusPlayer > 2 || replayFile || recordFile || tickRate <= 0.0)
+        {
+            std::cout << "A versus game is player 1 or 2, needs a fixed tick rate and can't be recorded" << std::endl;
+            return -1;
+        }
+        // both sides have to play the same game
+        if (!seeded)
+            Breakout.Seed = 0;
+        if (!link.Open(port, peerHost.c_str(), peerPort, Breakout.Seed + versusPlayer))
+        {
+            std::cout << "Failed to open port " << port << " to " << peerHost << ":" << peerPort << std::endl;
+            return -1;
+        }
+    }
+
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
@@ -51,38 +206,82 @@ int main(int argc, char* argv[])
     // initialize game
     // ---------------
     Breakout.Init();
+    if (stream)
+        Breakout.Sim.Level = Breakout.Sim.AddStreamedLevel(stream, scrollSpeed);
+    if (replayFile)
+        Breakout.Playback = &playback;
+    else if (recordFile)
+    {
+        recording.Begin(Breakout.Sim, Breakout.Seed, tickRate);
+        Breakout.Recording = &recording;
+    }
+    std::unique_ptr<LevelWatcher> watcher;
+    if (watchLevels)
+    {
+        watcher.reset(new LevelWatcher(Breakout.Sim.LevelFiles));
+        Breakout.Watcher = watcher.get();
+    }
+    std::unique_ptr<RollbackSession> session;
+    if (versusPlayer)
+    {
+        if (versusLevel >= Breakout.Sim.Levels.size())
+            versusLevel = 0;
+        Breakout.Sim.StartVersus(versusLevel);
+        session.reset(new RollbackSession(Breakout.Sim, versusPlayer - 1, inputDelay, static_cast<float>(1.0 / tickRate)));
+        Breakout.Session = session.get();
+        Breakout.Link = &link;
+    }
 
     // deltaTime variables
     // -------------------
-    float deltaTime = 0.0f;
-    float lastFrame = 0.0f;
+    // glfwGetTime is a monotonic clock in double precision; keep it that way so
+    // frame times don't lose resolution the longer the game runs
+    FixedTimestep timestep(tickRate > 0.0 ? tickRate : TICK_RATE, MAX_CATCH_UP_STEPS);
+    double deltaTime = 0.0;
+    double lastFrame = glfwGetTime();
 
     while (!glfwWindowShouldClose(window))
     {
         // calculate delta time
         // --------------------
-        float currentFrame = glfwGetTime();
+        double currentFrame = glfwGetTime();
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
         glfwPollEvents();
 
-        // manage user input
-        // -----------------
-        Breakout.ProcessInput(deltaTime);
-
-        // update game state
-        // -----------------
-        Breakout.Update(deltaTime);
+        // manage user input and update game state
+        // ---------------------------------------
+        Breakout.ReloadLevels();
+        Breakout.Sim.AdoptLoadedLevels();
+        float alpha = 1.0f;
+        if (tickRate > 0.0)
+        {
+            unsigned int ticks = timestep.Advance(deltaTime);
+            for (unsigned int i = 0; i < ticks; ++i)
+                Breakout.Tick(static_cast<float>(timestep.TickLength()));
+            alpha = timestep.Alpha();
+        }
+        else
+            Breakout.Tick(static_cast<float>(deltaTime));
+        Breakout.HandleEvents();
+        if (session && session->Failed)
+        {
+            std::cout << "ERROR: the versus game outgrew its rollback snapshots and had to stop" << std::endl;
+            glfwSetWindowShouldClose(window, true);
+        }
 
         // render
         // ------
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
-        Breakout.Render();
+        Breakout.Render(alpha);
 
         glfwSwapBuffers(window);
     }
 
+    if (recordFile && !recording.Save(recordFile))
+        std::cout << "Failed to save recording " << recordFile << std::endl;
+
     // delete all resources as loaded using the resource manager
     // ---------------------------------------------------------
     ResourceManager::Clear();
@@ -96,13 +295,17 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
     // when a user presses the escape key, we set the WindowShouldClose property to true, closing the application
     if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
         glfwSetWindowShouldClose(window, true);
+    // F5 saves the game, F9 goes back to the saved state
+    if (key == GLFW_KEY_F5 && action == GLFW_PRESS)
+        Breakout.QuickSave();
+    if (key == GLFW_KEY_F9 && action == GLFW_PRESS)
+        Breakout.QuickLoad();
     if (key >= 0 && key < 1024)
     {
         if (action == GLFW_PRESS)
             Breakout.Keys[key] = true;
         else if (action == GLFW_RELEASE) {
             Breakout.Keys[key] = false;
-            Breakout.KeysProcessed[key] = false;
         }
     }
 }
@@ -0,0 +1,60 @@
+#include "alias_table.h"
+
+#include <cmath>
+
+// Largest threshold: the whole column
+const double FULL_COLUMN = 4294967296.0;
+
+void AliasTable::Build(const std::vector<double>& weights)
+{
+    unsigned int count = static_cast<unsigned int>(weights.size());
+    double total = 0.0;
+    for (double weight : weights)
+        total += weight;
+    // Vose's method: columns scaled so the average is one, split into the
+    // ones below and above it; each small column is topped up by a large one
+    std::vector<double> scaled(count);
+    std::vector<unsigned int> small, large;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        scaled[i] = weights[i] * count / total;
+        (scaled[i] < 1.0 ? small : large).push_back(i);
+    }
+    this->Thresholds.assign(count, 0);
+    this->Aliases.resize(count);
+    for (unsigned int i = 0; i < count; ++i)
+        this->Aliases[i] = i;
+    while (!small.empty() && !large.empty())
+    {
+        unsigned int lesser = small.back(), greater = large.back();
+        small.pop_back();
+        this->Thresholds[lesser] = static_cast<uint32_t>(std::floor(scaled[lesser] * FULL_COLUMN));
+        this->Aliases[lesser] = greater;
+        scaled[greater] -= 1.0 - scaled[lesser];
+        if (scaled[greater] < 1.0)
+        {
+            large.pop_back();
+            small.push_back(greater);
+        }
+    }
+    // what is left is one up to rounding errors, so those columns keep
+    // their outcome whole: their alias is the outcome itself
+    for (unsigned int i : small)
+        this->Thresholds[i] = UINT32_MAX;
+    for (unsigned int i : large)
+        this->Thresholds[i] = UINT32_MAX;
+}
+
+double AliasTable::Probability(unsigned int outcome) const
+{
+    double share = 0.0;
+    for (unsigned int i = 0; i < this->Size(); ++i)
+    {
+        double kept = this->Thresholds[i] / FULL_COLUMN;
+        if (i == outcome)
+            share += kept;
+        if (this->Aliases[i] == outcome)
+            share += 1.0 - kept;
+    }
+    return share / this->Size();
+}
@@ -0,0 +1,36 @@
+#ifndef ALIAS_TABLE_H
+#define ALIAS_TABLE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "pcg32.h"
+
+// AliasTable samples from a fixed discrete distribution in constant time
+// with Walker's alias method. Every outcome owns one column; a column
+// keeps its own outcome below its threshold and hands the rest of its
+// width to its alias. A sample takes a single 32-bit draw: the high part
+// of draw * columns picks the column and the low part is compared with
+// the column's threshold.
+class AliasTable
+{
+public:
+    std::vector<uint32_t>     Thresholds;   // chance of keeping the column's own outcome, in 2^-32 units
+    std::vector<unsigned int> Aliases;
+    // builds the table for outcomes with the given weights; they need not
+    // sum to one, but at least one must be positive
+    void Build(const std::vector<double>& weights);
+    // number of outcomes
+    unsigned int Size() const { return static_cast<unsigned int>(this->Thresholds.size()); }
+    // one outcome, drawn with its weight's share of the total
+    unsigned int Sample(Pcg32& random) const
+    {
+        uint64_t scaled = static_cast<uint64_t>(random.Next()) * this->Thresholds.size();
+        unsigned int column = static_cast<unsigned int>(scaled >> 32);
+        return static_cast<uint32_t>(scaled) < this->Thresholds[column] ? column : this->Aliases[column];
+    }
+    // the exact chance of an outcome as the table stores it, rounding included
+    double Probability(unsigned int outcome) const;
+};
+
+#endif
@@ -0,0 +1,205 @@
+#include "autopilot.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// first standing brick the center entering the level grid over [0, tEnd]
+// bounces off; returns its index and sets tHit and the axis (0: x, 1: y) of
+// the cell face it crossed, or returns -1. Like Simulation::hitBrick, balls
+// pass through breakable bricks under pass-through and solid ones as ghosts
+static int FirstBrick(const GameLevel& level, bool passThrough, bool ghost, glm::vec2 position, glm::vec2 velocity, float tEnd, float& tHit, int& axis)
+{
+    if (level.Grid.empty())
+        return -1;
+    // work in cells
+    glm::vec2 q = (position - level.Origin) / level.UnitSize;
+    glm::vec2 dq = velocity / level.UnitSize;
+    float size[2] = { static_cast<float>(level.GridWidth), static_cast<float>(level.GridHeight) };
+    // clip the segment to the grid
+    float t0 = 0.0f, t1 = tEnd;
+    axis = -1;
+    for (int a = 0; a < 2; ++a)
+    {
+        if (dq[a] == 0.0f)
+        {
+            if (q[a] < 0.0f || q[a] >= size[a])
+                return -1;
+            continue;
+        }
+        float enter = (0.0f - q[a]) / dq[a], leave = (size[a] - q[a]) / dq[a];
+        if (enter > leave)
+            std::swap(enter, leave);
+        if (enter > t0)
+        {
+            t0 = enter;
+            axis = a;
+        }
+        t1 = std::min(t1, leave);
+    }
+    if (t0 >= t1)
+        return -1;
+    // starting cell, nudged along the direction of travel so a start on a cell face picks the cell ahead
+    int cell[2], step[2];
+    float next[2], delta[2];
+    for (int a = 0; a < 2; ++a)
+    {
+        step[a] = dq[a] > 0.0f ? 1 : (dq[a] < 0.0f ? -1 : 0);
+        float start = q[a] + dq[a] * t0 + step[a] * 1e-4f;
+        cell[a] = std::min(std::max(static_cast<int>(std::floor(start)), 0), static_cast<int>(size[a]) - 1);
+        next[a] = step[a] == 0 ? std::numeric_limits<float>::infinity() : (cell[a] + (step[a] > 0 ? 1 : 0) - q[a]) / dq[a];
+        delta[a] = step[a] == 0 ? std::numeric_limits<float>::infinity() : std::abs(1.0f / dq[a]);
+    }
+    float t = t0;
+    const BrickStore& bricks = level.Bricks;
+    for (;;)
+    {
+        int brick = level.Grid[cell[1] * level.GridWidth + cell[0]];
+        // a ball starting inside a cell is already past its faces
+        if (brick >= 0 && axis >= 0 && !bricks.IsDestroyed(brick) && (bricks.Solid.Test(brick) ? !ghost : !passThrough))
+        {
+            tHit = t;
+            return brick;
+        }
+        axis = next[0] < next[1] ? 0 : 1;
+        t = next[axis];
+        if (t > t1)
+            return -1;
+        cell[axis] += step[axis];
+        if (cell[axis] < 0 || cell[axis] >= static_cast<int>(size[axis]))
+            return -1;
+        next[axis] += delta[axis];
+    }
+}
+
+BallPath Autopilot::Trace(const Simulation& sim, glm::vec2 center, glm::vec2 velocity, float lineY, bool stopAtBrick)
+{
+    enum { NOTHING, SIDE, TOP, LINE, OUT };
+    const GameLevel& level = sim.Levels[sim.Level];
+    float radius = sim.Balls.Radius;
+    BallPath path;
+    path.Reached = false;
+    path.Brick = -1;
+    path.Time = 0.0f;
+    path.Bounces = 0;
+    for (; path.Bounces < MAX_TRACE_BOUNCES; ++path.Bounces)
+    {
+        // the nearest of walls, paddle line and leaving the screen
+        float time = std::numeric_limits<float>::infinity();
+        int event = NOTHING;
+        auto consider = [&](float t, int what) {
+            t = std::max(t, 0.0f);
+            if (t < time)
+            {
+                time = t;
+                event = what;
+            }
+        };
+        if (velocity.x > 0.0f)
+            consider((sim.Width - radius - center.x) / velocity.x, SIDE);
+        else if (velocity.x < 0.0f)
+            consider((radius - center.x) / velocity.x, SIDE);
+        if ((lineY - center.y) * velocity.y > 0.0f)
+            consider((lineY - center.y) / velocity.y, LINE);
+        if (velocity.y > 0.0f)
+            consider((sim.Height + radius - center.y) / velocity.y, OUT);
+        else if (velocity.y < 0.0f)
+            consider((sim.Versus ? -radius - center.y : radius - center.y) / velocity.y, sim.Versus ? OUT : TOP);
+        if (event == NOTHING)
+            break;
+        float hit;
+        int axis;
+        int brick = FirstBrick(level, sim.Balls.PassThrough, sim.Balls.Ghost, center, velocity, time, hit, axis);
+        if (brick >= 0)
+        {
+            center += velocity * hit;
+            path.Time += hit;
+            if (stopAtBrick && !level.Bricks.Solid.Test(brick))
+            {
+                path.Brick = brick;
+                break;
+            }
+            velocity[axis] = -velocity[axis];
+            continue;
+        }
+        center += velocity * time;
+        path.Time += time;
+        if (event == SIDE)
+            velocity.x = -velocity.x;
+        else if (event == TOP)
+            velocity.y = -velocity.y;
+        else
+        {
+            path.Reached = event == LINE;
+            break;
+        }
+    }
+    path.Position = center;
+    path.Velocity = velocity;
+    return path;
+}
+
+unsigned int Autopilot::Keys(const Simulation& sim, unsigned int player, float dt)
+{
+    const GameObject& paddle = player == PLAYER_TWO ? sim.Opponent : sim.Player;
+    const BallPool& balls = sim.Balls;
+    float radius = balls.Radius;
+    // height of a ball's center touching the paddle, and which way shots leave it
+    float lineY = player == PLAYER_TWO ? paddle.Position.y + paddle.Size.y + radius : paddle.Position.y - radius;
+    float away = player == PLAYER_TWO ? 1.0f : -1.0f;
+    // the ball that reaches the paddle first
+    BallPath incoming;
+    this->Ball = -1;
+    for (unsigned int i = 0; i < balls.Size(); ++i)
+    {
+        if (balls.Stuck.Test(i))
+            continue;
+        BallPath path = Trace(sim, balls.Positions[i] + radius, balls.Velocities[i], lineY, false);
+        if (path.Reached && (this->Ball < 0 || path.Time < incoming.Time))
+        {
+            this->Ball = static_cast<int>(i);
+            incoming = path;
+        }
+    }
+    float center = paddle.Position.x + paddle.Size.x / 2.0f;
+    float goal = center;
+    if (this->Ball >= 0)
+    {
+        this->Contact = incoming.Position;
+        // try offsets along the paddle; Simulation::hitPaddle turns the offset into the return direction
+        float speed = glm::length(incoming.Velocity);
+        float best = -1.0f, aim = 0.0f;
+        int target = -1;
+        for (unsigned int k = 0; k < AIM_CANDIDATES; ++k)
+        {
+            float offset = -AIM_LIMIT + 2.0f * AIM_LIMIT * k / (AIM_CANDIDATES - 1);
+            glm::vec2 shot = glm::normalize(glm::vec2(INITIAL_BALL_VELOCITY.x * offset * 2.0f, std::abs(incoming.Velocity.y))) * speed;
+            shot.y = away * std::abs(shot.y);
+            BallPath path = Trace(sim, incoming.Position, shot, lineY, true);
+            // shots at a brick first, the current target above all, then shots that come back;
+            // among those the fewest bounces, which are the least off, and the middle of the paddle,
+            // where a misjudged contact still hits it
+            float score = path.Brick >= 0 ? (path.Brick == this->Target ? 3.0f : 2.0f) : (path.Reached ? 1.0f : 0.0f);
+            score -= 0.05f * path.Bounces + 0.1f * std::abs(offset);
+            if (score > best)
+            {
+                best = score;
+                aim = offset;
+                target = path.Brick;
+            }
+        }
+        this->Target = target;
+        goal = incoming.Position.x - aim * paddle.Size.x / 2.0f;
+    }
+    else if (balls.Size() > 0)
+        goal = balls.Positions[0].x + radius; // lost in a long rally among the bricks; stay near it
+    goal = glm::clamp(goal, paddle.Size.x / 2.0f, sim.Width - paddle.Size.x / 2.0f);
+    // launch right away; stop within a tick's move of the goal
+    unsigned int keys = GAME_KEY_LAUNCH;
+    float deadZone = PLAYER_VELOCITY * dt;
+    if (goal < center - deadZone)
+        keys |= GAME_KEY_LEFT;
+    else if (goal > center + deadZone)
+        keys |= GAME_KEY_RIGHT;
+    return keys;
+}
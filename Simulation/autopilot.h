@@ -0,0 +1,50 @@
+#ifndef AUTOPILOT_H
+#define AUTOPILOT_H
+
+#include <glm/glm.hpp>
+
+#include "controller.h"
+
+// Most wall and brick bounces a ball path is followed through
+const unsigned int MAX_TRACE_BOUNCES = 32;
+// Number of paddle offsets the autopilot tries when aiming a return
+const unsigned int AIM_CANDIDATES = 9;
+// Largest offset from the paddle center tried, in half paddle widths
+const float AIM_LIMIT = 0.8f;
+
+// Where a traced ball ends up: on the paddle line, at a brick, or nowhere
+// within the bounce limit. Position is the ball's center.
+struct BallPath {
+    bool      Reached;      // arrived at the paddle line
+    int       Brick;        // brick the trace stopped at, or -1
+    float     Time;         // seconds until then
+    glm::vec2 Position, Velocity;
+    unsigned int Bounces;
+};
+
+// Autopilot is a Controller that plays by predicting ball paths instead of
+// chasing the ball. It follows each ball's path analytically, folding it
+// at the walls like BallObject::Move and at standing bricks by walking the
+// level's grid index cell by cell, to find where and when it crosses the
+// paddle line. For the ball that arrives first it then tries a few
+// offsets along the paddle, traces the return shot each one would give
+// and moves under the ball at the offset whose shot hits a breakable
+// brick; it keeps aiming at the same brick while it stands. Bricks are
+// treated as the cells they fill and the ball as its center, which is
+// close enough to steer by and keeps a decision to a few microseconds.
+class Autopilot : public Controller
+{
+public:
+    // what the last decision was based on, e.g. for drawing it
+    int       Ball;         // ball being played, or -1 when none is on its way
+    glm::vec2 Contact;      // where its center meets the paddle line
+    int       Target;       // brick aimed at, or -1
+    // constructor
+    Autopilot() : Ball(-1), Contact(0.0f), Target(-1) { }
+    unsigned int Keys(const Simulation& sim, unsigned int player, float dt) override;
+    // follows a ball with the given center and velocity until its center reaches
+    // height lineY, or, with stopAtBrick, until it touches a breakable brick
+    static BallPath Trace(const Simulation& sim, glm::vec2 center, glm::vec2 velocity, float lineY, bool stopAtBrick);
+};
+
+#endif
@@ -15,7 +15,7 @@ public:
 
 
     BallObject();
-    BallObject(glm::vec2 pos, float radius, glm::vec2 velocity, Texture2D sprite);
+    BallObject(glm::vec2 pos, float radius, glm::vec2 velocity);
 
     glm::vec2 Move(float dt, unsigned int window_width);
     void      Reset(glm::vec2 position, glm::vec2 velocity);
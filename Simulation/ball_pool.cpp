@@ -0,0 +1,87 @@
+#include "ball_pool.h"
+
+BallPool::BallPool(float radius)
+    : Radius(radius), Color(1.0f), Sticky(false), PassThrough(false), Ghost(false)
+{
+}
+
+unsigned int BallPool::Add(glm::vec2 position, glm::vec2 velocity, bool stuck, unsigned char owner)
+{
+    if (this->Size() >= MAX_BALLS)
+        return MAX_BALLS;
+    this->Positions.push_back(position);
+    this->Velocities.push_back(velocity);
+    this->OldVelocities.push_back(velocity);
+    this->Stuck.PushBack(stuck);
+    this->Owners.push_back(owner);
+    return this->Size() - 1;
+}
+
+void BallPool::Remove(unsigned int i)
+{
+    unsigned int last = this->Size() - 1;
+    this->Positions[i] = this->Positions[last];
+    this->Velocities[i] = this->Velocities[last];
+    this->OldVelocities[i] = this->OldVelocities[last];
+    this->Owners[i] = this->Owners[last];
+    if (this->Stuck.Test(last))
+        this->Stuck.Set(i);
+    else
+        this->Stuck.Reset(i);
+    this->Positions.pop_back();
+    this->Velocities.pop_back();
+    this->OldVelocities.pop_back();
+    this->Owners.pop_back();
+    this->Stuck.PopBack();
+}
+
+void BallPool::Clear()
+{
+    this->Positions.clear();
+    this->Velocities.clear();
+    this->OldVelocities.clear();
+    this->Owners.clear();
+    this->Stuck.Clear();
+}
+
+BallObject BallPool::Get(unsigned int i) const
+{
+    BallObject ball(this->Positions[i], this->Radius, this->Velocities[i]);
+    ball.Color = this->Color;
+    ball.Stuck = this->Stuck.Test(i);
+    ball.Sticky = this->Sticky;
+    ball.PassThrough = this->PassThrough;
+    ball.Ghost = this->Ghost;
+    ball.oldVelocity = this->OldVelocities[i];
+    return ball;
+}
+
+void BallPool::Move(float dt, unsigned int window_width)
+{
+    float size = this->Radius * 2.0f;
+    for (unsigned int i = 0; i < this->Size(); ++i)
+    {
+        if (this->Stuck.Test(i))
+            continue;
+        glm::vec2& position = this->Positions[i];
+        glm::vec2& velocity = this->Velocities[i];
+        // move the ball
+        position += velocity * dt;
+        // check if outside window bounds; if so, reverse velocity and restore at correct position
+        if (position.x <= 0.0f)
+        {
+            velocity.x = -velocity.x;
+            position.x = 0.0f;
+        }
+        else if (position.x + size >= window_width)
+        {
+            velocity.x = -velocity.x;
+            position.x = window_width - size;
+        }
+        if (position.y <= 0.0f)
+        {
+            velocity.y = -velocity.y;
+            position.y = 0.0f;
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef BALL_POOL_H
+#define BALL_POOL_H
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "ball_object.h"
+#include "bit_set.h"
+
+// Maximum number of balls in play at once
+const unsigned int MAX_BALLS = 1024;
+
+// BallPool keeps every ball in play as parallel arrays, like BrickStore
+// does for bricks: ball i is at Positions[i] moving with Velocities[i],
+// and is stuck to the paddle when bit i of Stuck is set. Owners[i] is
+// the player whose paddle the ball last touched (always 0 outside versus). All balls share
+// a radius, and the powerup effects (sticky, pass-through, ghost and the
+// color showing them) apply to the whole pool.
+class BallPool
+{
+public:
+    // per ball state
+    std::vector<glm::vec2> Positions;
+    std::vector<glm::vec2> Velocities;
+    std::vector<glm::vec2> OldVelocities;  // velocity before slowmo slowed it down
+    BitSet                 Stuck;
+    std::vector<unsigned char> Owners;
+    // shared state
+    float                  Radius;
+    glm::vec3              Color;
+    bool                   Sticky, PassThrough, Ghost;
+    // constructor
+    BallPool(float radius);
+    // number of balls
+    unsigned int Size() const { return static_cast<unsigned int>(this->Positions.size()); }
+    // adds a ball and returns its index, or MAX_BALLS when the pool is full
+    unsigned int Add(glm::vec2 position, glm::vec2 velocity, bool stuck, unsigned char owner = 0);
+    // removes ball i by moving the last ball into its slot
+    void Remove(unsigned int i);
+    // removes all balls; the shared effects are kept
+    void Clear();
+    // the ball at index i as a standalone object, e.g. for drawing
+    BallObject Get(unsigned int i) const;
+    // moves every ball that isn't stuck and bounces it off the walls, like BallObject::Move
+    void Move(float dt, unsigned int window_width);
+};
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef BIT_SET_H
+#define BIT_SET_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// BitSet is a dynamically sized set of flags packed 64 to a word,
+// so whole-set questions can be answered a word at a time.
+class BitSet
+{
+public:
+    // storage; bits past Count in the last word are always zero
+    std::vector<uint64_t> Words;
+    unsigned int          Count;
+    // constructor
+    BitSet() : Count(0) { }
+    // resizes to count bits, all cleared
+    void Assign(unsigned int count)
+    {
+        this->Count = count;
+        this->Words.assign((count + 63) / 64, 0);
+    }
+    // adds a bit at the end
+    void PushBack(bool value)
+    {
+        if (this->Count % 64 == 0)
+            this->Words.push_back(0);
+        if (value)
+            this->Set(this->Count);
+        ++this->Count;
+    }
+    // removes the last bit
+    void PopBack()
+    {
+        this->Reset(--this->Count);
+        if (this->Count % 64 == 0)
+            this->Words.pop_back();
+    }
+    void Clear()
+    {
+        this->Words.clear();
+        this->Count = 0;
+    }
+    bool Test(unsigned int i) const { return (this->Words[i >> 6] >> (i & 63)) & 1; }
+    void Set(unsigned int i)        { this->Words[i >> 6] |= uint64_t(1) << (i & 63); }
+    void Reset(unsigned int i)      { this->Words[i >> 6] &= ~(uint64_t(1) << (i & 63)); }
+    // clears every bit, keeping the count
+    void ResetAll()                 { std::fill(this->Words.begin(), this->Words.end(), 0); }
+};
+
+#endif
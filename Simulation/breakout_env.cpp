@@ -0,0 +1,63 @@
+#include "breakout_env.h"
+
+#include <cstring>
+
+#include "vec_env.h"
+
+struct BreakoutEnv {
+    VecEnv Env;
+
+    BreakoutEnv(unsigned int count, unsigned int level, unsigned int threads) : Env(count, level, threads) { }
+};
+
+BreakoutEnv* breakout_env_create(unsigned int count, unsigned int level, unsigned int threads)
+{
+    BreakoutEnv* env = new BreakoutEnv(count, level, threads);
+    if (!env->Env.Ready())
+    {
+        delete env;
+        return nullptr;
+    }
+    return env;
+}
+
+void breakout_env_destroy(BreakoutEnv* env)
+{
+    delete env;
+}
+
+void breakout_env_configure(BreakoutEnv* env, unsigned int ticksPerStep, unsigned int maxTicks)
+{
+    env->Env.TicksPerStep = ticksPerStep > 0 ? ticksPerStep : 1;
+    env->Env.MaxTicks = maxTicks;
+}
+
+unsigned int breakout_env_features(void)
+{
+    return OBS_FEATURES;
+}
+
+unsigned int breakout_env_brick_words(const BreakoutEnv* env)
+{
+    return env->Env.BrickWords();
+}
+
+void breakout_env_reset(BreakoutEnv* env, uint64_t seed)
+{
+    env->Env.Reset(seed);
+}
+
+void breakout_env_step(BreakoutEnv* env, const unsigned char* actions, float* rewards, unsigned char* dones)
+{
+    VecEnv& vec = env->Env;
+    vec.Step(actions);
+    if (rewards)
+        std::memcpy(rewards, vec.Rewards.data(), vec.Count * sizeof(float));
+    if (dones)
+        std::memcpy(dones, vec.Dones.data(), vec.Count);
+}
+
+void breakout_env_observe(const BreakoutEnv* env, float* features, uint64_t* bricks)
+{
+    env->Env.Observe(features, bricks);
+}
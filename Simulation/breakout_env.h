@@ -0,0 +1,38 @@
+#ifndef BREAKOUT_ENV_H
+#define BREAKOUT_ENV_H
+
+#include <stdint.h>
+
+/* C interface to VecEnv for training code in other languages (ctypes,
+   cffi, a C extension). Buffers are owned by the caller and laid out
+   instance after instance; see vec_env.h for the observation features,
+   rewards and when a game is done. Run from the directory holding levels/. */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct BreakoutEnv BreakoutEnv;
+
+/* creates count instances playing the given level on threads workers (0: one per
+   hardware thread); returns NULL when the levels can't be loaded */
+BreakoutEnv* breakout_env_create(unsigned int count, unsigned int level, unsigned int threads);
+void breakout_env_destroy(BreakoutEnv* env);
+/* ticks of 1/120 s an action is held for, and the ticks after which a game is cut off (0: never) */
+void breakout_env_configure(BreakoutEnv* env, unsigned int ticksPerStep, unsigned int maxTicks);
+/* floats per instance in an observation, and 64-bit words per instance in the brick bitmap */
+unsigned int breakout_env_features(void);
+unsigned int breakout_env_brick_words(const BreakoutEnv* env);
+/* starts every instance over; instance i gets seed + i */
+void breakout_env_reset(BreakoutEnv* env, uint64_t seed);
+/* steps every instance with its action (GameKey bits: 1 left, 2 right, 4 launch); rewards
+   and dones receive one entry per instance, either may be NULL */
+void breakout_env_step(BreakoutEnv* env, const unsigned char* actions, float* rewards, unsigned char* dones);
+/* writes count * breakout_env_features() floats and count * breakout_env_brick_words() words */
+void breakout_env_observe(const BreakoutEnv* env, float* features, uint64_t* bricks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
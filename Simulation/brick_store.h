@@ -0,0 +1,153 @@
+#ifndef BRICK_STORE_H
+#define BRICK_STORE_H
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "bit_set.h"
+
+// Colors of the brick kinds; the kind of a brick is its tile code,
+// with every code above 5 drawn white.
+const glm::vec3 BRICK_COLORS[] = {
+    glm::vec3(1.0f),                // 0: empty tile, unused
+    glm::vec3(0.8f, 0.8f, 0.7f),    // 1: solid
+    glm::vec3(0.2f, 0.6f, 1.0f),    // 2
+    glm::vec3(0.0f, 0.7f, 0.0f),    // 3
+    glm::vec3(0.8f, 0.8f, 0.4f),    // 4
+    glm::vec3(1.0f, 0.5f, 0.0f),    // 5
+    glm::vec3(1.0f)                 // 6: any other code
+};
+const unsigned char BRICK_KIND_SOLID = 1;
+const unsigned char BRICK_KIND_MAX = 6;
+
+// the kind of brick a tile code makes
+inline unsigned char BrickKind(unsigned int tileCode)
+{
+    return static_cast<unsigned char>(tileCode > BRICK_KIND_MAX ? BRICK_KIND_MAX : tileCode);
+}
+
+// BrickProgress counts the breakable bricks of a store, in total and per
+// kind. The store updates it as bricks are added and destroyed, so the
+// game, the HUD and the tools read progress without walking the bricks.
+struct BrickProgress {
+    unsigned int Total, Remaining;
+    unsigned int TotalByKind[BRICK_KIND_MAX + 1];
+    unsigned int RemainingByKind[BRICK_KIND_MAX + 1];
+
+    BrickProgress() { this->Clear(); }
+    void Clear()
+    {
+        this->Total = this->Remaining = 0;
+        for (unsigned int kind = 0; kind <= BRICK_KIND_MAX; ++kind)
+            this->TotalByKind[kind] = this->RemainingByKind[kind] = 0;
+    }
+    unsigned int Destroyed() const                         { return this->Total - this->Remaining; }
+    unsigned int DestroyedByKind(unsigned char kind) const { return this->TotalByKind[kind] - this->RemainingByKind[kind]; }
+};
+
+// BrickStore keeps the bricks of a level as parallel arrays: brick i
+// is at Positions[i] with Sizes[i], drawn as Kinds[i], and its solid and
+// destroyed flags are bit i of the two bit sets. Collision and rendering
+// walk the arrays they need linearly and never touch the rest. Bricks
+// are only ever destroyed through Destroy, which keeps Progress in sync.
+class BrickStore
+{
+public:
+    // brick state
+    std::vector<glm::vec2>      Positions;
+    std::vector<glm::vec2>      Sizes;
+    std::vector<unsigned char>  Kinds;
+    BitSet                      Solid;
+    BitSet                      Destroyed;
+    BrickProgress               Progress;
+    // number of bricks
+    unsigned int Size() const { return static_cast<unsigned int>(this->Kinds.size()); }
+    void Clear()
+    {
+        this->Positions.clear();
+        this->Sizes.clear();
+        this->Kinds.clear();
+        this->Solid.Clear();
+        this->Destroyed.Clear();
+        this->Progress.Clear();
+    }
+    // adds a brick for the given tile code and returns its index
+    unsigned int Add(glm::vec2 position, glm::vec2 size, unsigned int tileCode)
+    {
+        this->Positions.push_back(position);
+        this->Sizes.push_back(size);
+        unsigned char kind = BrickKind(tileCode);
+        this->Kinds.push_back(kind);
+        this->Solid.PushBack(kind == BRICK_KIND_SOLID);
+        this->Destroyed.PushBack(false);
+        this->count(this->Size() - 1, 1);
+        return this->Size() - 1;
+    }
+    // turns brick i into a standing brick of the given tile code's kind
+    void Change(unsigned int i, unsigned int tileCode)
+    {
+        this->count(i, -1);
+        unsigned char kind = BrickKind(tileCode);
+        this->Kinds[i] = kind;
+        if (kind == BRICK_KIND_SOLID)
+            this->Solid.Set(i);
+        else
+            this->Solid.Reset(i);
+        this->Destroyed.Reset(i);
+        this->count(i, 1);
+    }
+    // removes brick i by moving the last brick into its slot; the last brick's index goes away
+    void Remove(unsigned int i)
+    {
+        this->count(i, -1);
+        unsigned int last = this->Size() - 1;
+        this->Positions[i] = this->Positions[last];
+        this->Sizes[i] = this->Sizes[last];
+        this->Kinds[i] = this->Kinds[last];
+        if (this->Solid.Test(last)) this->Solid.Set(i); else this->Solid.Reset(i);
+        if (this->Destroyed.Test(last)) this->Destroyed.Set(i); else this->Destroyed.Reset(i);
+        this->Positions.pop_back();
+        this->Sizes.pop_back();
+        this->Kinds.pop_back();
+        this->Solid.PopBack();
+        this->Destroyed.PopBack();
+    }
+    // brings every destroyed brick back
+    void RestoreAll()
+    {
+        this->Destroyed.ResetAll();
+        this->Progress.Remaining = this->Progress.Total;
+        for (unsigned int kind = 0; kind <= BRICK_KIND_MAX; ++kind)
+            this->Progress.RemainingByKind[kind] = this->Progress.TotalByKind[kind];
+    }
+    // destroys a breakable brick; returns false if it is solid or already destroyed
+    bool Destroy(unsigned int i)
+    {
+        if (this->Solid.Test(i) || this->Destroyed.Test(i))
+            return false;
+        this->Destroyed.Set(i);
+        --this->Progress.Remaining;
+        --this->Progress.RemainingByKind[this->Kinds[i]];
+        return true;
+    }
+    bool IsSolid(unsigned int i) const     { return this->Solid.Test(i); }
+    bool IsDestroyed(unsigned int i) const { return this->Destroyed.Test(i); }
+    glm::vec3 Color(unsigned int i) const  { return BRICK_COLORS[this->Kinds[i]]; }
+private:
+    // adds brick i to the progress counts, or with sign -1 takes it out of them
+    void count(unsigned int i, int sign)
+    {
+        unsigned char kind = this->Kinds[i];
+        if (kind == BRICK_KIND_SOLID)
+            return;
+        this->Progress.Total += sign;
+        this->Progress.TotalByKind[kind] += sign;
+        if (!this->Destroyed.Test(i))
+        {
+            this->Progress.Remaining += sign;
+            this->Progress.RemainingByKind[kind] += sign;
+        }
+    }
+};
+
+#endif
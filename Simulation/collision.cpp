@@ -0,0 +1,155 @@
+#include "collision.h"
+
+#include <algorithm>
+#include <cmath>
+
+bool CheckCollision(const GameObject &one, const GameObject &two) // AABB - AABB collision
+{
+    // collision x-axis?
+    bool collisionX = one.Position.x + one.Size.x >= two.Position.x &&
+                      two.Position.x + two.Size.x >= one.Position.x;
+    // collision y-axis?
+    bool collisionY = one.Position.y + one.Size.y >= two.Position.y &&
+                      two.Position.y + two.Size.y >= one.Position.y;
+    // collision only if on both axes
+    return collisionX && collisionY;
+}
+
+Collision CheckCollision(const BallObject& one, const GameObject& two) // AABB - Circle collision
+{
+    return CheckCollision(one, two.Position, two.Size);
+}
+
+Collision CheckCollision(const BallObject& one, glm::vec2 position, glm::vec2 size) // AABB - Circle collision
+{
+    // get center point circle first 
+    return CheckCollision(one.Position + one.Radius, one.Radius, position, size);
+}
+
+Collision CheckCollision(glm::vec2 center, float radius, glm::vec2 position, glm::vec2 size) // AABB - Circle collision
+{
+    // calculate AABB info (center, half-extents)
+    glm::vec2 aabb_half_extents(size.x / 2.0f, size.y / 2.0f);
+    glm::vec2 aabb_center(
+        position.x + aabb_half_extents.x,
+        position.y + aabb_half_extents.y
+    );
+    // get difference vector between both centers
+    glm::vec2 difference = center - aabb_center;
+    glm::vec2 clamped = glm::clamp(difference, -aabb_half_extents, aabb_half_extents);
+    // add clamped value to AABB_center and we get the value of box closest to circle
+    glm::vec2 closest = aabb_center + clamped;
+    // retrieve vector between center circle and closest point AABB and check if length <= radius
+    difference = closest - center;
+    if (glm::length(difference) <= radius)
+        return std::make_tuple(true, VectorDirection(difference), difference);
+    else
+        return std::make_tuple(false, UP, glm::vec2(0.0f, 0.0f));
+}
+
+// earliest time (0..1) at which a ray from origin along motion enters the circle, or -1 if it misses
+static float rayCircle(glm::vec2 origin, glm::vec2 motion, glm::vec2 circle, float radius)
+{
+    glm::vec2 m = origin - circle;
+    float a = glm::dot(motion, motion);
+    float b = glm::dot(m, motion);
+    float c = glm::dot(m, m) - radius * radius;
+    float discriminant = b * b - a * c;
+    if (a == 0.0f || discriminant < 0.0f)
+        return -1.0f;
+    return (-b - std::sqrt(discriminant)) / a;
+}
+
+SweepHit SweepCircleAABB(glm::vec2 center, float radius, glm::vec2 motion, glm::vec2 boxMin, glm::vec2 boxMax)
+{
+    SweepHit result;
+    // already touching: report an immediate hit if moving into the box. A circle whose
+    // center is inside the box (e.g. a ghost ball when the powerup ran out) is let go
+    glm::vec2 closest = glm::clamp(center, boxMin, boxMax);
+    glm::vec2 difference = center - closest;
+    float distance2 = glm::dot(difference, difference);
+    if (distance2 <= radius * radius)
+    {
+        if (distance2 > 0.0f)
+        {
+            glm::vec2 normal = difference / std::sqrt(distance2);
+            if (glm::dot(motion, normal) < 0.0f)
+            {
+                result.Hit = true;
+                result.Time = 0.0f;
+                result.Normal = normal;
+            }
+        }
+        return result;
+    }
+    // ray against the box expanded by the radius (slab test)
+    glm::vec2 expandedMin = boxMin - radius, expandedMax = boxMax + radius;
+    float tEnter = 0.0f, tExit = 1.0f;
+    glm::vec2 normal(0.0f);
+    for (int axis = 0; axis < 2; ++axis)
+    {
+        if (motion[axis] == 0.0f)
+        {
+            if (center[axis] < expandedMin[axis] || center[axis] > expandedMax[axis])
+                return result;
+            continue;
+        }
+        float t1 = (expandedMin[axis] - center[axis]) / motion[axis];
+        float t2 = (expandedMax[axis] - center[axis]) / motion[axis];
+        float sign = -1.0f;
+        if (t1 > t2)
+        {
+            std::swap(t1, t2);
+            sign = 1.0f;
+        }
+        if (t1 > tEnter)
+        {
+            tEnter = t1;
+            normal = glm::vec2(0.0f);
+            normal[axis] = sign;
+        }
+        tExit = std::min(tExit, t2);
+        if (tEnter > tExit)
+            return result;
+    }
+    // the expanded box has square corners; if we enter through one, test the actual rounded corner
+    glm::vec2 point = center + motion * tEnter;
+    bool outsideX = point.x < boxMin.x || point.x > boxMax.x;
+    bool outsideY = point.y < boxMin.y || point.y > boxMax.y;
+    if (outsideX && outsideY)
+    {
+        glm::vec2 corner(point.x < boxMin.x ? boxMin.x : boxMax.x, point.y < boxMin.y ? boxMin.y : boxMax.y);
+        float t = rayCircle(center, motion, corner, radius);
+        if (t < 0.0f || t > 1.0f)
+            return result;
+        tEnter = t;
+        normal = glm::normalize(center + motion * t - corner);
+    }
+    result.Hit = true;
+    result.Time = tEnter;
+    result.Normal = normal;
+    return result;
+}
+
+Direction VectorDirection(glm::vec2 target)
+{
+    // the compass direction with the largest dot product against the normalized
+    // target; normalizing scales all four products equally, so compare the raw ones
+    float dot_products[] = {
+        target.y,   // up
+        target.x,   // right
+        -target.y,  // down
+        -target.x   // left
+    };
+    float max = 0.0f;
+    unsigned int best_match = -1;
+    for (unsigned int i = 0; i < 4; i++)
+    {
+        if (dot_products[i] > max)
+        {
+            max = dot_products[i];
+            best_match = i;
+        }
+    }
+    return (Direction)best_match;
+}
@@ -0,0 +1,44 @@
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include <tuple>
+#include <glm/glm.hpp>
+
+#include "game_object.h"
+#include "ball_object.h"
+
+enum Direction {
+	UP,
+	RIGHT,
+	DOWN,
+	LEFT
+};
+
+typedef std::tuple<bool, Direction, glm::vec2> Collision;
+
+// Result of sweeping a circle along a motion vector. Time is the fraction
+// of the motion (0..1) at which the circle first touches the obstacle and
+// Normal is the unit contact normal pointing from the obstacle to the circle.
+struct SweepHit {
+    bool      Hit;
+    float     Time;
+    glm::vec2 Normal;
+
+    SweepHit() : Hit(false), Time(1.0f), Normal(0.0f) { }
+};
+
+// returns the compass direction that is closest to the given vector
+Direction VectorDirection(glm::vec2 target);
+// AABB - AABB collision
+bool CheckCollision(const GameObject& one, const GameObject& two);
+// circle - AABB collision, returns whether it hit, the side it hit and the vector from the circle center to the closest point
+Collision CheckCollision(const BallObject& one, const GameObject& two);
+Collision CheckCollision(const BallObject& one, glm::vec2 position, glm::vec2 size);
+Collision CheckCollision(glm::vec2 center, float radius, glm::vec2 position, glm::vec2 size);
+// continuous circle - AABB collision: sweeps a circle with the given center and radius
+// along motion and returns the earliest time of impact with the box [boxMin, boxMax].
+// Circles already touching the box only count when they move further into it.
+// Circles whose center is inside the box never collide so they can leave it.
+SweepHit SweepCircleAABB(glm::vec2 center, float radius, glm::vec2 motion, glm::vec2 boxMin, glm::vec2 boxMax);
+
+#endif
@@ -0,0 +1,163 @@
+#include "collision_simd.h"
+
+#include <algorithm>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define BREAKOUT_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang only emit AVX2 instructions in functions marked for it;
+// MSVC accepts the intrinsics anywhere.
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+
+// Every kernel performs the same operations as the scalar CheckCollision:
+// the box center and half extents, the difference between the centers
+// clamped to the half extents gives the closest point, and the vector from
+// the circle center to it is compared against the radius.
+
+static unsigned int collideScalar(glm::vec2 center, float radius, const BrickBatch& batch, BatchContacts& contacts)
+{
+    unsigned int mask = 0;
+    float radius2 = radius * radius;
+    for (unsigned int i = 0; i < batch.Count; ++i)
+    {
+        float halfX = batch.W[i] / 2.0f, halfY = batch.H[i] / 2.0f;
+        float boxX = batch.X[i] + halfX, boxY = batch.Y[i] + halfY;
+        float clampedX = std::min(std::max(center.x - boxX, -halfX), halfX);
+        float clampedY = std::min(std::max(center.y - boxY, -halfY), halfY);
+        contacts.X[i] = boxX + clampedX - center.x;
+        contacts.Y[i] = boxY + clampedY - center.y;
+        if (contacts.X[i] * contacts.X[i] + contacts.Y[i] * contacts.Y[i] <= radius2)
+            mask |= 1u << i;
+    }
+    return mask;
+}
+
+#ifdef BREAKOUT_X86
+static unsigned int collideSSE2(glm::vec2 center, float radius, const BrickBatch& batch, BatchContacts& contacts)
+{
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    const __m128 cx = _mm_set1_ps(center.x), cy = _mm_set1_ps(center.y);
+    const __m128 radius2 = _mm_set1_ps(radius * radius);
+    unsigned int mask = 0;
+    for (unsigned int i = 0; i < BATCH_WIDTH; i += 4)
+    {
+        __m128 halfX = _mm_mul_ps(_mm_load_ps(batch.W + i), half);
+        __m128 halfY = _mm_mul_ps(_mm_load_ps(batch.H + i), half);
+        __m128 boxX = _mm_add_ps(_mm_load_ps(batch.X + i), halfX);
+        __m128 boxY = _mm_add_ps(_mm_load_ps(batch.Y + i), halfY);
+        __m128 clampedX = _mm_min_ps(_mm_max_ps(_mm_sub_ps(cx, boxX), _mm_xor_ps(halfX, sign)), halfX);
+        __m128 clampedY = _mm_min_ps(_mm_max_ps(_mm_sub_ps(cy, boxY), _mm_xor_ps(halfY, sign)), halfY);
+        __m128 dx = _mm_sub_ps(_mm_add_ps(boxX, clampedX), cx);
+        __m128 dy = _mm_sub_ps(_mm_add_ps(boxY, clampedY), cy);
+        _mm_store_ps(contacts.X + i, dx);
+        _mm_store_ps(contacts.Y + i, dy);
+        __m128 distance2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        mask |= static_cast<unsigned int>(_mm_movemask_ps(_mm_cmple_ps(distance2, radius2))) << i;
+    }
+    return mask & ((1u << batch.Count) - 1);
+}
+
+TARGET_AVX2
+static unsigned int collideAVX2(glm::vec2 center, float radius, const BrickBatch& batch, BatchContacts& contacts)
+{
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    const __m256 cx = _mm256_set1_ps(center.x), cy = _mm256_set1_ps(center.y);
+    __m256 halfX = _mm256_mul_ps(_mm256_load_ps(batch.W), half);
+    __m256 halfY = _mm256_mul_ps(_mm256_load_ps(batch.H), half);
+    __m256 boxX = _mm256_add_ps(_mm256_load_ps(batch.X), halfX);
+    __m256 boxY = _mm256_add_ps(_mm256_load_ps(batch.Y), halfY);
+    __m256 clampedX = _mm256_min_ps(_mm256_max_ps(_mm256_sub_ps(cx, boxX), _mm256_xor_ps(halfX, sign)), halfX);
+    __m256 clampedY = _mm256_min_ps(_mm256_max_ps(_mm256_sub_ps(cy, boxY), _mm256_xor_ps(halfY, sign)), halfY);
+    __m256 dx = _mm256_sub_ps(_mm256_add_ps(boxX, clampedX), cx);
+    __m256 dy = _mm256_sub_ps(_mm256_add_ps(boxY, clampedY), cy);
+    _mm256_store_ps(contacts.X, dx);
+    _mm256_store_ps(contacts.Y, dy);
+    // no FMA here: keep the rounding identical to the SSE2 and scalar kernels
+    __m256 distance2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+    unsigned int mask = static_cast<unsigned int>(_mm256_movemask_ps(_mm256_cmp_ps(distance2, _mm256_set1_ps(radius * radius), _CMP_LE_OQ)));
+    return mask & ((1u << batch.Count) - 1);
+}
+
+static bool cpuHasAVX2()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    // the OS has to save the AVX registers (OSXSAVE and XCR0 bits 1 and 2)
+    if (!(info[2] & (1 << 27)) || (_xgetbv(0) & 6) != 6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+SimdLevel SupportedSimdLevel()
+{
+#ifdef BREAKOUT_X86
+    static const SimdLevel level = cpuHasAVX2() ? SIMD_AVX2 : SIMD_SSE2;
+    return level;
+#else
+    return SIMD_SCALAR;
+#endif
+}
+
+const char* SimdLevelName(SimdLevel level)
+{
+    switch (level)
+    {
+    case SIMD_SSE2: return "SSE2";
+    case SIMD_AVX2: return "AVX2";
+    default:        return "scalar";
+    }
+}
+
+unsigned int CollideBatch(SimdLevel level, glm::vec2 center, float radius, const BrickBatch& batch, BatchContacts& contacts)
+{
+    level = std::min(level, SupportedSimdLevel());
+#ifdef BREAKOUT_X86
+    if (level == SIMD_AVX2)
+        return collideAVX2(center, radius, batch, contacts);
+    if (level == SIMD_SSE2)
+        return collideSSE2(center, radius, batch, contacts);
+#endif
+    return collideScalar(center, radius, batch, contacts);
+}
+
+typedef unsigned int (*BatchKernel)(glm::vec2 center, float radius, const BrickBatch& batch, BatchContacts& contacts);
+
+static BatchKernel selectKernel()
+{
+#ifdef BREAKOUT_X86
+    if (SupportedSimdLevel() == SIMD_AVX2)
+        return collideAVX2;
+    return collideSSE2;
+#else
+    return collideScalar;
+#endif
+}
+
+// the kernel used by the game, chosen once
+static const BatchKernel bestKernel = selectKernel();
+
+unsigned int CollideBatch(glm::vec2 center, float radius, const BrickBatch& batch, BatchContacts& contacts)
+{
+    return bestKernel(center, radius, batch, contacts);
+}
@@ -0,0 +1,51 @@
+#ifndef COLLISION_SIMD_H
+#define COLLISION_SIMD_H
+
+#include <glm/glm.hpp>
+
+// Number of bricks tested by one call of the batched narrow phase
+const unsigned int BATCH_WIDTH = 8;
+
+// Up to BATCH_WIDTH bricks gathered into lanes for the batched narrow phase.
+// Lanes at or past Count are ignored.
+struct BrickBatch {
+    alignas(32) float X[BATCH_WIDTH], Y[BATCH_WIDTH];   // top-left corner
+    alignas(32) float W[BATCH_WIDTH], H[BATCH_WIDTH];   // size
+    unsigned int      Indices[BATCH_WIDTH];             // brick index of every lane
+    unsigned int      Count;
+
+    BrickBatch() : X(), Y(), W(), H(), Count(0) { }
+    void Add(unsigned int index, glm::vec2 position, glm::vec2 size)
+    {
+        X[Count] = position.x; Y[Count] = position.y;
+        W[Count] = size.x;     H[Count] = size.y;
+        Indices[Count++] = index;
+    }
+};
+
+// Per lane contact of a batch: the vector from the ball center to the closest
+// point of the brick, i.e. the contact normal scaled by the distance. It equals
+// the third element of the scalar CheckCollision result.
+struct BatchContacts {
+    alignas(32) float X[BATCH_WIDTH], Y[BATCH_WIDTH];
+};
+
+// Instruction sets the batched narrow phase can run on
+enum SimdLevel {
+    SIMD_SCALAR,
+    SIMD_SSE2,
+    SIMD_AVX2
+};
+
+// circle - AABB collision of one ball against a batch of bricks. Returns a
+// mask with bit i set when lane i touches the circle, comparing squared
+// distances, and fills in the contact vectors of all lanes. Runs the widest
+// kernel the CPU supports, picked once at startup.
+unsigned int CollideBatch(glm::vec2 center, float radius, const BrickBatch& batch, BatchContacts& contacts);
+// the same test with an explicit kernel; asking for an unsupported level falls back to the best supported one
+unsigned int CollideBatch(SimdLevel level, glm::vec2 center, float radius, const BrickBatch& batch, BatchContacts& contacts);
+// the widest kernel supported by this CPU
+SimdLevel SupportedSimdLevel();
+const char* SimdLevelName(SimdLevel level);
+
+#endif
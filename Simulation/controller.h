@@ -0,0 +1,20 @@
+#ifndef CONTROLLER_H
+#define CONTROLLER_H
+
+#include "simulation.h"
+
+// Controller drives a paddle in place of a person at the keyboard: every
+// tick it looks at the game and returns the GameKey bits to hold, the same
+// mask a client builds from its keys. Since it only produces keys, whatever
+// consumes keys (ProcessKeys, recordings, rollback sessions) works with a
+// controller unchanged. Implementations must not touch the simulation's
+// random stream, so a controlled game still replays from its keys.
+class Controller
+{
+public:
+    virtual ~Controller() { }
+    // keys the given player holds during the next tick of dt seconds
+    virtual unsigned int Keys(const Simulation& sim, unsigned int player, float dt) = 0;
+};
+
+#endif
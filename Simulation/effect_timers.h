@@ -0,0 +1,68 @@
+#ifndef EFFECT_TIMERS_H
+#define EFFECT_TIMERS_H
+
+#include <algorithm>
+#include <vector>
+
+#include "powerup.h"
+
+// A timed powerup effect that runs out once the clock reaches Expiry
+struct EffectTimer {
+    double      Expiry;
+    PowerUpType Type;
+};
+
+// EffectTimers keeps track of the timed powerup effects in play. Active
+// counts the running effects of each type, so whether a type is active is
+// a lookup, and Heap is a binary min-heap of expiry times, so starting an
+// effect and finding the ones that ran out cost O(log n) however many are
+// stacked on top of each other. Expiry times are absolute on Clock, the
+// seconds the timers have been advanced; nothing has to be counted down
+// per effect every tick.
+class EffectTimers
+{
+public:
+    double                   Clock;
+    unsigned int             Active[POWERUP_TYPES];  // running effects per type
+    std::vector<EffectTimer> Heap;                   // soonest expiry first
+    // constructor
+    EffectTimers() { this->Clear(); }
+    // stops every effect without running out
+    void Clear()
+    {
+        this->Clock = 0.0;
+        std::fill(this->Active, this->Active + POWERUP_TYPES, 0u);
+        this->Heap.clear();
+    }
+    // whether an effect of the type is running
+    bool IsActive(PowerUpType type) const { return this->Active[type] > 0; }
+    // number of running effects
+    unsigned int Size() const { return static_cast<unsigned int>(this->Heap.size()); }
+    // starts an effect that runs for duration seconds
+    void Start(PowerUpType type, float duration)
+    {
+        ++this->Active[type];
+        this->Heap.push_back(EffectTimer{ this->Clock + duration, type });
+        std::push_heap(this->Heap.begin(), this->Heap.end(), later);
+    }
+    // advances the clock by dt and removes the effects that ran out; calls
+    // expired(type) for every type whose last running effect was among them
+    template <typename Expired>
+    void Advance(float dt, Expired expired)
+    {
+        this->Clock += dt;
+        while (!this->Heap.empty() && this->Heap.front().Expiry <= this->Clock)
+        {
+            std::pop_heap(this->Heap.begin(), this->Heap.end(), later);
+            PowerUpType type = this->Heap.back().Type;
+            this->Heap.pop_back();
+            if (--this->Active[type] == 0)
+                expired(type);
+        }
+    }
+private:
+    // heap order: the later timer sinks
+    static bool later(const EffectTimer& a, const EffectTimer& b) { return a.Expiry > b.Expiry; }
+};
+
+#endif
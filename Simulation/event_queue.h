@@ -0,0 +1,115 @@
+#ifndef EVENT_QUEUE_H
+#define EVENT_QUEUE_H
+
+#include <glm/glm.hpp>
+
+// Things that happen during a tick which code outside the collision loop
+// reacts to: sound and particles in the client, statistics in the tools.
+// The simulation keeps its own record of what changes the game, since the
+// queue may overwrite events (see Simulation::applyEvents).
+enum SimEventType {
+    EVENT_BRICK_DESTROYED,      // Position: the brick, Kind: its brick kind, Player: the ball's owner
+    EVENT_SOLID_HIT,            // Position: the first solid brick hit
+    EVENT_PADDLE_HIT,           // Position: the first ball that hit it, Player: whose paddle
+    EVENT_POWERUP_COLLECTED,    // Position: the powerup, Kind: its PowerUpType, Player: who caught it
+    EVENT_TYPES
+};
+
+// One entry of the EventQueue. Events of the same type, kind and player
+// within a tick are coalesced into one entry that counts them, except
+// destroyed bricks which each keep their position since every one may
+// drop a powerup.
+struct SimEvent {
+    unsigned char  Type;
+    unsigned char  Kind;
+    unsigned char  Player;
+    unsigned short Count;
+    glm::vec2      Position;
+};
+
+// Number of events the queue holds; a power of two so positions wrap with a mask
+const unsigned int EVENT_QUEUE_CAPACITY = 1024;
+
+// EventQueue is a fixed size ring buffer of SimEvents. The collision code
+// only appends to it, so hits never allocate or call out of the loop;
+// consumers walk the events once per tick or drain them once per frame.
+// When nobody drains it (headless runs) the oldest events are overwritten,
+// or it is muted and drops them as they come.
+class EventQueue
+{
+public:
+    // constructor
+    EventQueue() : head(0), tail(0), tickStart(0), muted(false) { this->BeginTick(); }
+    // number of queued events
+    unsigned int Size() const { return this->tail - this->head; }
+    // i-th queued event, oldest first
+    const SimEvent& operator[](unsigned int i) const { return this->events[(this->head + i) & (EVENT_QUEUE_CAPACITY - 1)]; }
+    // starts a new tick; events only coalesce with others of the same tick
+    void BeginTick()
+    {
+        this->tickStart = this->tail;
+        for (unsigned int& last : this->lastOfType)
+            last = this->tickStart;
+    }
+    // appends an event, or counts it against the tick's entry of the same type, kind and player
+    void Push(SimEventType type, glm::vec2 position, unsigned char kind = 0, unsigned char player = 0)
+    {
+        if (this->muted)
+            return;
+        // positions wrap, so they are compared by their distance from the tail
+        unsigned int last = this->lastOfType[type];
+        if (type != EVENT_BRICK_DESTROYED && this->tail - last < this->Size() && this->tail - last < this->tail - this->tickStart)
+        {
+            SimEvent& event = this->events[(last - 1) & (EVENT_QUEUE_CAPACITY - 1)];
+            if (event.Kind == kind && event.Player == player && event.Count < 0xffff)
+            {
+                ++event.Count;
+                return;
+            }
+        }
+        if (this->Size() == EVENT_QUEUE_CAPACITY)
+            ++this->head;
+        SimEvent& event = this->events[this->tail & (EVENT_QUEUE_CAPACITY - 1)];
+        event.Type = static_cast<unsigned char>(type);
+        event.Kind = kind;
+        event.Player = player;
+        event.Count = 1;
+        event.Position = position;
+        this->lastOfType[type] = ++this->tail;
+    }
+    // calls visit(event) for every event of the current tick
+    template <typename Visitor>
+    void ForEachInTick(Visitor visit) const
+    {
+        for (unsigned int i = this->tail - this->tickStart < this->Size() ? this->tickStart : this->head; i != this->tail; ++i)
+            visit(this->events[i & (EVENT_QUEUE_CAPACITY - 1)]);
+    }
+    // calls consume(event) for every queued event, oldest first, and empties the queue
+    template <typename Consumer>
+    void Drain(Consumer consume)
+    {
+        for (; this->head != this->tail; ++this->head)
+            consume(this->events[this->head & (EVENT_QUEUE_CAPACITY - 1)]);
+    }
+    void Clear() { this->head = this->tail; }
+    // a muted queue drops every event pushed, for games nobody watches
+    void Mute(bool muted) { this->muted = muted; }
+    // position the next event will be queued at, for Rewind
+    unsigned int Position() const { return this->tail; }
+    // drops the events queued since Position returned position, e.g. those of ticks run again
+    void Rewind(unsigned int position)
+    {
+        if (this->tail - position > this->Size())
+            this->head = position; // they overwrote everything before
+        this->tail = position;
+    }
+private:
+    SimEvent     events[EVENT_QUEUE_CAPACITY];
+    // positions count up forever and are masked on access
+    unsigned int head, tail, tickStart;
+    bool         muted;
+    // one past the position of the tick's latest event of each type, tickStart when there is none
+    unsigned int lastOfType[EVENT_TYPES];
+};
+
+#endif
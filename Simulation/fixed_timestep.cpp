@@ -0,0 +1,33 @@
+#include "fixed_timestep.h"
+
+#include <cmath>
+
+FixedTimestep::FixedTimestep(double tickRate, unsigned int maxSteps)
+    : TickRate(tickRate), MaxSteps(maxSteps), Accumulator(0.0) { }
+
+double FixedTimestep::TickLength() const
+{
+    return 1.0 / this->TickRate;
+}
+
+unsigned int FixedTimestep::Advance(double frameTime)
+{
+    double tick = this->TickLength();
+    if (frameTime > 0.0)
+        this->Accumulator += frameTime;
+    unsigned int steps = static_cast<unsigned int>(this->Accumulator / tick);
+    if (steps > this->MaxSteps)
+    {
+        // too far behind: run what we may and drop the remaining whole ticks
+        steps = this->MaxSteps;
+        this->Accumulator = std::fmod(this->Accumulator, tick);
+    }
+    else
+        this->Accumulator -= steps * tick;
+    return steps;
+}
+
+float FixedTimestep::Alpha() const
+{
+    return static_cast<float>(this->Accumulator / this->TickLength());
+}
@@ -0,0 +1,27 @@
+#ifndef FIXED_TIMESTEP_H
+#define FIXED_TIMESTEP_H
+
+// FixedTimestep converts variable frame times into a whole number of
+// fixed-length simulation ticks. Left-over time stays in the accumulator
+// and is exposed as an interpolation factor for rendering. A frame never
+// runs more than MaxSteps ticks; time beyond that is dropped so a slow
+// frame cannot snowball into ever longer catch-up frames.
+class FixedTimestep
+{
+public:
+    // configuration
+    double       TickRate;  // simulation ticks per second
+    unsigned int MaxSteps;  // maximum number of catch-up ticks per frame
+    // state
+    double       Accumulator;
+    // constructor
+    FixedTimestep(double tickRate = 120.0, unsigned int maxSteps = 8);
+    // length of a single tick in seconds
+    double TickLength() const;
+    // adds the elapsed frame time and returns the number of ticks to run this frame
+    unsigned int Advance(double frameTime);
+    // how far (0..1) the current frame is between the last two ticks
+    float Alpha() const;
+};
+
+#endif
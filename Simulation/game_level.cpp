@@ -0,0 +1,292 @@
+#include "game_level.h"
+#include "level_file.h"
+#include "mapped_file.h"
+
+#include <cstring>
+
+void GameLevel::Load(const char* file, unsigned int levelWidth, unsigned int levelHeight, glm::vec2 origin) {
+    // clear old data
+    this->Bricks.Clear();
+    this->Grid.clear();
+    // compiled levels are read in place; a damaged or outdated one stays empty rather than parsed as text
+    {
+        MappedFile compiled(file);
+        if (HasCompiledMagic(compiled.Data(), compiled.Size()))
+        {
+            if (IsCompiledLevel(compiled.Data(), compiled.Size()))
+                this->initCompiled(compiled.Data(), levelWidth, levelHeight, origin);
+            return;
+        }
+    }
+    // load from file
+    std::vector<std::vector<unsigned int>> tileData;
+    if (ReadLevelText(file, tileData) && tileData.size() > 0)
+        this->init(tileData, levelWidth, levelHeight, origin);
+}
+
+void GameLevel::Load(const std::vector<std::vector<unsigned int>>& tileData, unsigned int levelWidth, unsigned int levelHeight, glm::vec2 origin)
+{
+    this->Bricks.Clear();
+    this->Grid.clear();
+    if (tileData.size() > 0)
+        this->init(tileData, levelWidth, levelHeight, origin);
+}
+
+void GameLevel::Reset(glm::vec2 origin)
+{
+    if (this->source)
+    {
+        this->restartStream();
+        return;
+    }
+    this->Bricks.RestoreAll();
+    if (origin == this->Origin)
+        return;
+    // moved, e.g. into the versus band: lay the bricks out again the way loading does
+    this->Origin = origin;
+    for (unsigned int cell = 0; cell < this->Grid.size(); ++cell)
+        if (this->Grid[cell] >= 0)
+        {
+            unsigned int x = cell % this->GridWidth, y = cell / this->GridWidth;
+            this->Bricks.Positions[this->Grid[cell]] = origin + glm::vec2(this->UnitSize.x * x, this->UnitSize.y * y);
+        }
+}
+
+unsigned int GameLevel::Patch(const std::vector<std::vector<unsigned int>>& tileData, unsigned int lvlWidth, unsigned int lvlHeight)
+{
+    if (this->source)
+        return 0;
+    unsigned int height = static_cast<unsigned int>(tileData.size());
+    unsigned int width = height > 0 ? static_cast<unsigned int>(tileData[0].size()) : 0;
+    if (width != this->GridWidth || height != this->GridHeight)
+    {
+        this->Load(tileData, lvlWidth, lvlHeight, this->Origin);
+        return width * height;
+    }
+    BrickStore& bricks = this->Bricks;
+    unsigned int changed = 0;
+    for (unsigned int y = 0; y < height; ++y)
+    {
+        for (unsigned int x = 0; x < width; ++x)
+        {
+            int& cell = this->Grid[y * width + x];
+            unsigned int tile = x < tileData[y].size() ? tileData[y][x] : 0;
+            unsigned char kind = BrickKind(tile);
+            if (kind == (cell >= 0 ? bricks.Kinds[cell] : 0))
+                continue;
+            ++changed;
+            if (cell >= 0 && kind > 0)
+                bricks.Change(cell, tile);
+            else if (kind > 0)
+                cell = static_cast<int>(bricks.Add(this->Origin + glm::vec2(this->UnitSize.x * x, this->UnitSize.y * y), this->UnitSize, tile));
+            else
+            {   // the last brick moves into the removed one's slot; point its cell there
+                unsigned int last = bricks.Size() - 1;
+                glm::vec2 lastCell = (bricks.Positions[last] - this->Origin) / this->UnitSize;
+                this->Grid[std::lround(lastCell.y) * width + std::lround(lastCell.x)] = cell;
+                bricks.Remove(cell);
+                cell = -1;
+            }
+        }
+    }
+    return changed;
+}
+
+void GameLevel::Stream(std::shared_ptr<const ChunkSource> source, unsigned int lvlWidth, float rowHeight, float bottom)
+{
+    this->Bricks.Clear();
+    this->source = source;
+    this->bottom = bottom;
+    unsigned int width = source->Columns();
+    this->GridWidth = width;
+    this->GridHeight = STREAM_CHUNKS * STREAM_CHUNK_ROWS;
+    this->UnitSize = glm::vec2(lvlWidth / static_cast<float>(width), rowHeight);
+    this->Grid.assign(width * this->GridHeight, -1);
+    // the store is sized once for all resident chunks; empty cells are kept as destroyed bricks
+    unsigned int count = width * this->GridHeight;
+    this->Bricks.Positions.assign(count, glm::vec2(0.0f));
+    this->Bricks.Sizes.assign(count, this->UnitSize);
+    this->Bricks.Kinds.assign(count, 0);
+    this->Bricks.Solid.Assign(count);
+    this->Bricks.Destroyed.Assign(count);
+    this->restartStream();
+}
+
+void GameLevel::restartStream()
+{
+    this->Origin = glm::vec2(0.0f, this->bottom - this->GridHeight * this->UnitSize.y);
+    this->nextRow = 0;
+    this->crossed = 0;
+    this->Bricks.Progress.Clear();
+    std::fill(this->Grid.begin(), this->Grid.end(), -1);
+    // the first rows go to the bottom band
+    for (unsigned int band = STREAM_CHUNKS; band-- > 0; )
+    {
+        this->chunkSlots[band] = band;
+        this->pageIn(band, band);
+    }
+}
+
+void GameLevel::pageIn(unsigned int slot, unsigned int band)
+{
+    BrickStore& bricks = this->Bricks;
+    unsigned int width = this->GridWidth;
+    for (unsigned int row = 0; row < STREAM_CHUNK_ROWS; ++row)
+    {
+        // rows fill the band from the bottom up
+        unsigned int y = band * STREAM_CHUNK_ROWS + STREAM_CHUNK_ROWS - 1 - row;
+        unsigned int first = (slot * STREAM_CHUNK_ROWS + row) * width;
+        unsigned char* kinds = &bricks.Kinds[first];
+        if (this->nextRow < this->source->Rows())
+            this->source->Row(this->nextRow++, kinds);
+        else
+            std::fill(kinds, kinds + width, 0);
+        for (unsigned int x = 0; x < width; ++x)
+        {
+            unsigned int i = first + x;
+            unsigned char kind = std::min(kinds[x], BRICK_KIND_MAX);
+            kinds[x] = kind;
+            bricks.Positions[i] = this->Origin + glm::vec2(this->UnitSize.x * x, this->UnitSize.y * y);
+            if (kind == BRICK_KIND_SOLID)
+                bricks.Solid.Set(i);
+            else
+                bricks.Solid.Reset(i);
+            if (kind == 0)
+            {
+                bricks.Destroyed.Set(i);
+                this->Grid[y * width + x] = -1;
+                continue;
+            }
+            bricks.Destroyed.Reset(i);
+            this->Grid[y * width + x] = static_cast<int>(i);
+            if (kind != BRICK_KIND_SOLID)
+            {
+                ++bricks.Progress.Total;
+                ++bricks.Progress.Remaining;
+                ++bricks.Progress.TotalByKind[kind];
+                ++bricks.Progress.RemainingByKind[kind];
+            }
+        }
+    }
+}
+
+unsigned int GameLevel::Scroll(float dy, float floor)
+{
+    if (!this->source)
+        return 0;
+    BrickStore& bricks = this->Bricks;
+    unsigned int width = this->GridWidth;
+    unsigned int dropped = 0;
+    this->Origin.y += dy;
+    // rows whose bottom edge passed the floor leave play, live bricks and all
+    while (this->Origin.y + (this->GridHeight - this->crossed) * this->UnitSize.y > floor)
+    {
+        int* row = &this->Grid[(this->GridHeight - 1 - this->crossed) * width];
+        for (unsigned int x = 0; x < width; ++x)
+        {
+            if (row[x] < 0)
+                continue;
+            unsigned int i = static_cast<unsigned int>(row[x]);
+            if (bricks.Destroy(i))
+            {   // it was never destroyed by a ball, so it no longer counts at all
+                --bricks.Progress.Total;
+                --bricks.Progress.TotalByKind[bricks.Kinds[i]];
+                ++dropped;
+            }
+            bricks.Destroyed.Set(i);
+            row[x] = -1;
+        }
+        // a chunk that left play entirely is recycled for the next rows, at the top
+        if (++this->crossed == STREAM_CHUNK_ROWS)
+        {
+            unsigned int slot = this->chunkSlots[STREAM_CHUNKS - 1];
+            std::copy_backward(this->chunkSlots, this->chunkSlots + STREAM_CHUNKS - 1, this->chunkSlots + STREAM_CHUNKS);
+            this->chunkSlots[0] = slot;
+            unsigned int chunkCells = STREAM_CHUNK_ROWS * width;
+            std::copy_backward(this->Grid.begin(), this->Grid.end() - chunkCells, this->Grid.end());
+            this->Origin.y -= STREAM_CHUNK_ROWS * this->UnitSize.y;
+            this->crossed = 0;
+            this->pageIn(slot, 0);
+        }
+    }
+    // bricks follow the grid; laid out from it again so positions don't drift over a long level
+    for (unsigned int y = 0; y < this->GridHeight; ++y)
+    {
+        float top = this->Origin.y + this->UnitSize.y * y;
+        const int* row = &this->Grid[y * width];
+        for (unsigned int x = 0; x < width; ++x)
+            if (row[x] >= 0)
+                bricks.Positions[row[x]].y = top;
+    }
+    return dropped;
+}
+
+void GameLevel::layout(unsigned int width, unsigned int height, unsigned int lvlWidth, unsigned int lvlHeight, glm::vec2 origin)
+{
+    // calculate dimensions
+    float unit_width = lvlWidth / static_cast<float>(width);
+    float unit_height = lvlHeight / height;
+    this->GridWidth = width;
+    this->GridHeight = height;
+    this->Origin = origin;
+    this->UnitSize = glm::vec2(unit_width, unit_height);
+    this->Grid.assign(width * height, -1);
+}
+
+void GameLevel::init(const std::vector<std::vector<unsigned int>>& tileData,
+    unsigned int lvlWidth, unsigned int lvlHeight, glm::vec2 origin)
+{
+    unsigned int height = tileData.size();
+    unsigned int width = tileData[0].size();
+    this->layout(width, height, lvlWidth, lvlHeight, origin);
+    // initialize level tiles based on tileData
+    for (unsigned int y = 0; y < height; ++y)
+    {
+        for (unsigned int x = 0; x < width && x < tileData[y].size(); ++x)
+        {
+            // every non-zero tile code is a brick, 1 being solid (see BRICK_COLORS)
+            if (tileData[y][x] > 0)
+            {
+                glm::vec2 pos = origin + glm::vec2(this->UnitSize.x * x, this->UnitSize.y * y);
+                this->Grid[y * width + x] = static_cast<int>(this->Bricks.Add(pos, this->UnitSize, tileData[y][x]));
+            }
+        }
+    }
+}
+
+void GameLevel::initCompiled(const unsigned char* data, unsigned int lvlWidth, unsigned int lvlHeight, glm::vec2 origin)
+{
+    LevelFileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.Height == 0)
+        return;
+    this->layout(header.Width, header.Height, lvlWidth, lvlHeight, origin);
+    // the sections follow the header back to back
+    unsigned int count = header.Bricks;
+    const unsigned char* solid = data + sizeof(header);
+    const unsigned char* cells = solid + (count + 63) / 64 * sizeof(uint64_t);
+    const unsigned char* kinds = cells + count * sizeof(uint32_t);
+    // the store is filled as a whole instead of brick by brick; IsCompiledLevel
+    // made sure the kinds are in range and the solid bits, totals and tiles agree with them
+    BrickStore& bricks = this->Bricks;
+    bricks.Kinds.assign(kinds, kinds + count);
+    bricks.Solid.Assign(count);
+    std::memcpy(bricks.Solid.Words.data(), solid, bricks.Solid.Words.size() * sizeof(uint64_t));
+    bricks.Destroyed.Assign(count);
+    bricks.Sizes.assign(count, this->UnitSize);
+    bricks.Positions.resize(count);
+    for (unsigned int kind = 0; kind <= BRICK_KIND_MAX; ++kind)
+    {
+        bricks.Progress.TotalByKind[kind] = bricks.Progress.RemainingByKind[kind] = header.TotalByKind[kind];
+        bricks.Progress.Total += header.TotalByKind[kind];
+    }
+    bricks.Progress.Remaining = bricks.Progress.Total;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        uint32_t cell;
+        std::memcpy(&cell, cells + i * sizeof(uint32_t), sizeof(cell));
+        unsigned int x = cell % header.Width, y = cell / header.Width;
+        bricks.Positions[i] = origin + glm::vec2(this->UnitSize.x * x, this->UnitSize.y * y);
+        this->Grid[cell] = static_cast<int>(i);
+    }
+}
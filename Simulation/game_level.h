@@ -0,0 +1,117 @@
+#ifndef GAME_LEVEL_H
+#define GAME_LEVEL_H
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <glm/glm.hpp>
+#include "brick_store.h"
+#include "level_stream.h"
+
+// GameLevel holds the bricks of a level. Bricks are laid out on the
+// regular tile grid of the level file, so next to the brick list the
+// level keeps a grid index that maps every tile cell to the slot of
+// the brick occupying it. Collision code uses it to only look at the
+// few cells around the ball instead of scanning every brick. The grid
+// starts at Origin, the top left corner of the area the level fills.
+//
+// A streamed level gets its rows from a ChunkSource instead and scrolls
+// down the screen. It keeps STREAM_CHUNKS chunks of rows resident in a
+// store of fixed size, chunk slot k owning the bricks from k times the
+// bricks of a chunk on; once the bottom chunk scrolled out of play its slot
+// is filled with the next rows and moves to the top. Paging never
+// allocates, so a level of any length plays in constant memory.
+class GameLevel
+{
+public:
+    // level state
+    BrickStore              Bricks;
+    // grid index: tile cell (x, y) holds the index of its brick, or -1 when empty
+    unsigned int            GridWidth, GridHeight;
+    glm::vec2               Origin, UnitSize;
+    std::vector<int>        Grid;
+    // pixels per second a streamed level scrolls down
+    float                   ScrollSpeed;
+    // constructor
+    GameLevel() : GridWidth(0), GridHeight(0), Origin(0.0f), UnitSize(0.0f), ScrollSpeed(0.0f), nextRow(0), crossed(0), bottom(0.0f) { }
+    // loads level from a text or compiled level file (see level_file.h), filling levelWidth x levelHeight pixels from origin
+    void Load(const char* file, unsigned int levelWidth, unsigned int levelHeight, glm::vec2 origin = glm::vec2(0.0f));
+    // loads level from tile data (rows of tile codes)
+    void Load(const std::vector<std::vector<unsigned int>>& tileData, unsigned int levelWidth, unsigned int levelHeight, glm::vec2 origin = glm::vec2(0.0f));
+    // puts the level back the way it was loaded, laid out from origin. The
+    // loaded bricks are the level's template: playing only destroys them, so
+    // a reset brings them back without touching the file or reallocating
+    void Reset(glm::vec2 origin);
+    // brings the level in line with changed tile data, as it would be loaded
+    // into levelWidth x levelHeight pixels from its Origin. Only the cells
+    // whose brick kind changed are touched; the other bricks keep their
+    // place and destroyed state. A grid of another size is loaded anew.
+    // Returns the number of cells that changed
+    unsigned int Patch(const std::vector<std::vector<unsigned int>>& tileData, unsigned int levelWidth, unsigned int levelHeight);
+    // makes this a streamed level of rows levelWidth pixels wide and rowHeight
+    // high, its first row resting on the line at y = bottom
+    void Stream(std::shared_ptr<const ChunkSource> source, unsigned int levelWidth, float rowHeight, float bottom);
+    bool IsStreamed() const { return this->source != nullptr; }
+    // moves a streamed level dy pixels down; rows that reach the floor
+    // leave play and make room for new ones. Returns the breakable bricks
+    // that left play without being destroyed
+    unsigned int Scroll(float dy, float floor);
+    // check if the level is completed (all non-solid tiles are destroyed and, when streamed, no rows are left to come)
+    bool IsCompleted() const { return this->Bricks.Progress.Remaining == 0 && (!this->source || this->nextRow >= this->source->Rows()); }
+    // breakable bricks left and destroyed, in total and per kind
+    const BrickProgress& Progress() const { return this->Bricks.Progress; }
+    // bytes the level holds on to for its bricks and grid
+    size_t Footprint() const
+    {
+        const BrickStore& bricks = this->Bricks;
+        return bricks.Positions.capacity() * sizeof(glm::vec2) + bricks.Sizes.capacity() * sizeof(glm::vec2)
+            + bricks.Kinds.capacity() + (bricks.Solid.Words.capacity() + bricks.Destroyed.Words.capacity()) * sizeof(uint64_t)
+            + this->Grid.capacity() * sizeof(int);
+    }
+    // calls visit(brickIndex) for every brick whose cell overlaps the box [boxMin, boxMax], in row-major order
+    template <typename Visitor>
+    void ForEachBrickIn(glm::vec2 boxMin, glm::vec2 boxMax, Visitor visit);
+private:
+    // initialize level from tile data
+    void init(const std::vector<std::vector<unsigned int>>& tileData,
+        unsigned int levelWidth, unsigned int levelHeight, glm::vec2 origin);
+    // initialize level from the brick table of a compiled level file
+    void initCompiled(const unsigned char* data, unsigned int levelWidth, unsigned int levelHeight, glm::vec2 origin);
+    // sizes the grid index for width x height tiles and empties it
+    void layout(unsigned int width, unsigned int height, unsigned int levelWidth, unsigned int levelHeight, glm::vec2 origin);
+    // streaming state: the next source row, the grid rows at the bottom
+    // that left play, the chunk slot of every band of rows from the top,
+    // and where the first row starts out
+    std::shared_ptr<const ChunkSource> source;
+    uint64_t                nextRow;
+    unsigned int            crossed;
+    unsigned int            chunkSlots[STREAM_CHUNKS];
+    float                   bottom;
+    // fills the bricks of a chunk slot with the next rows and lays them out in the given band of grid rows
+    void pageIn(unsigned int slot, unsigned int band);
+    // starts the stream over from its first row
+    void restartStream();
+};
+
+template <typename Visitor>
+void GameLevel::ForEachBrickIn(glm::vec2 boxMin, glm::vec2 boxMax, Visitor visit)
+{
+    boxMin -= this->Origin;
+    boxMax -= this->Origin;
+    if (this->Grid.empty() || boxMax.x < 0.0f || boxMax.y < 0.0f)
+        return;
+    // clamp in floating point first so far away boxes can't overflow the cell indices
+    int x0 = static_cast<int>(std::max(std::floor(boxMin.x / this->UnitSize.x), 0.0f));
+    int y0 = static_cast<int>(std::max(std::floor(boxMin.y / this->UnitSize.y), 0.0f));
+    int x1 = static_cast<int>(std::min(boxMax.x / this->UnitSize.x, this->GridWidth - 1.0f));
+    int y1 = static_cast<int>(std::min(boxMax.y / this->UnitSize.y, this->GridHeight - 1.0f));
+    for (int y = y0; y <= y1; ++y)
+    {
+        const int* row = &this->Grid[y * this->GridWidth];
+        for (int x = x0; x <= x1; ++x)
+            if (row[x] >= 0)
+                visit(static_cast<unsigned int>(row[x]));
+    }
+}
+
+#endif
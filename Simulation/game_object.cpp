@@ -0,0 +1,6 @@
+#include "game_object.h"
+
+GameObject::GameObject() : Position(0.0, 0.0), Size(1.0, 1.0), Velocity(0.0), Color(1.0), Rotation(0.0), IsSolid(true), Destroyed(false) {}
+
+GameObject::GameObject(glm::vec2 pos, glm::vec2 size, glm::vec3 color, glm::vec2 velocity) :
+	Position(pos), Size(size), Velocity(velocity), Color(color), Rotation(0.0), IsSolid(false), Destroyed(false) {}
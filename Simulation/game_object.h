@@ -0,0 +1,22 @@
+#ifndef GAME_OBJECT_H
+#define GAME_OBJECT_H
+#include <glm/glm.hpp>
+
+// GameObject holds the simulation state of a single entity in the
+// game. It carries no render state so it can be used without an
+// OpenGL context; the client picks a sprite for it when drawing.
+class GameObject
+{
+public:
+    // object state
+    glm::vec2   Position, Size, Velocity;
+    glm::vec3   Color;
+    float       Rotation;
+    bool        IsSolid;
+    bool        Destroyed;
+    // constructor(s)
+    GameObject();
+    GameObject(glm::vec2 pos, glm::vec2 size, glm::vec3 color = glm::vec3(1.0f), glm::vec2 velocity = glm::vec2(0.0f, 0.0f));
+};
+
+#endif
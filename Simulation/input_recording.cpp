@@ -0,0 +1,161 @@
+#include "input_recording.h"
+#include "fixed_timestep.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+const char RECORDING_MAGIC[4] = { 'B', 'K', 'R', 'P' };
+const unsigned char RECORDING_VERSION = 1;
+
+// appends value as a LEB128 varint: 7 bits per byte, low bits first
+void WriteVarint(std::vector<unsigned char>& out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+// reads a LEB128 varint at cursor, returns false when the data ends in the middle of one
+bool ReadVarint(const std::vector<unsigned char>& in, size_t& cursor, uint64_t& value)
+{
+    value = 0;
+    for (unsigned int shift = 0; cursor < in.size() && shift < 64; shift += 7)
+    {
+        unsigned char byte = in[cursor++];
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+InputRecording::InputRecording()
+    : Seed(0), Width(0), Height(0), Level(0), ServeBalls(1), Collisions(COLLISION_SWEPT), TickRate(120.0),
+      Ticks(0), lastKeys(0), lastChange(0)
+{
+}
+
+void InputRecording::Begin(const Simulation& sim, uint64_t seed, double tickRate)
+{
+    this->Seed = seed;
+    this->Width = sim.Width;
+    this->Height = sim.Height;
+    this->Level = sim.Level;
+    this->ServeBalls = sim.ServeBalls;
+    this->Collisions = sim.Collisions;
+    this->TickRate = tickRate;
+    this->Ticks = 0;
+    this->Events.clear();
+    this->lastKeys = 0;
+    this->lastChange = 0;
+}
+
+void InputRecording::Record(unsigned int keys)
+{
+    if (keys != this->lastKeys)
+    {
+        WriteVarint(this->Events, this->Ticks - this->lastChange);
+        this->Events.push_back(static_cast<unsigned char>(keys));
+        this->lastKeys = keys;
+        this->lastChange = this->Ticks;
+    }
+    ++this->Ticks;
+}
+
+void InputRecording::Start(Simulation& sim) const
+{
+    // what Game::Init does, minus the rendering and audio
+    sim = Simulation(this->Width, this->Height);
+    sim.ServeBalls = this->ServeBalls;
+    sim.Collisions = this->Collisions;
+    sim.Seed(this->Seed);
+    sim.LoadLevels();
+    sim.SelectLevel(this->Level);
+    sim.State = GAME_MENU;
+}
+
+float InputRecording::TickLength() const
+{
+    return static_cast<float>(FixedTimestep(this->TickRate).TickLength());
+}
+
+bool InputRecording::Save(const char* file) const
+{
+    std::vector<unsigned char> data(RECORDING_MAGIC, RECORDING_MAGIC + 4);
+    data.push_back(RECORDING_VERSION);
+    WriteVarint(data, this->Seed);
+    WriteVarint(data, this->Width);
+    WriteVarint(data, this->Height);
+    WriteVarint(data, this->Level);
+    WriteVarint(data, this->ServeBalls);
+    WriteVarint(data, this->Collisions);
+    WriteVarint(data, this->Ticks);
+    uint64_t rate;
+    std::memcpy(&rate, &this->TickRate, sizeof(rate));
+    for (int i = 0; i < 8; ++i)
+        data.push_back(static_cast<unsigned char>(rate >> (8 * i)));
+    data.insert(data.end(), this->Events.begin(), this->Events.end());
+    std::ofstream out(file, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(data.data()), data.size());
+    return out.good();
+}
+
+bool InputRecording::Load(const char* file)
+{
+    std::ifstream in(file, std::ios::binary);
+    if (!in)
+        return false;
+    std::vector<unsigned char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (data.size() < 5 || std::memcmp(data.data(), RECORDING_MAGIC, 4) != 0 || data[4] != RECORDING_VERSION)
+        return false;
+    size_t cursor = 5;
+    uint64_t fields[7];
+    for (uint64_t& field : fields)
+        if (!ReadVarint(data, cursor, field))
+            return false;
+    if (cursor + 8 > data.size())
+        return false;
+    uint64_t rate = 0;
+    for (int i = 0; i < 8; ++i)
+        rate |= static_cast<uint64_t>(data[cursor++]) << (8 * i);
+    this->Seed = fields[0];
+    this->Width = static_cast<unsigned int>(fields[1]);
+    this->Height = static_cast<unsigned int>(fields[2]);
+    this->Level = static_cast<unsigned int>(fields[3]);
+    this->ServeBalls = static_cast<unsigned int>(fields[4]);
+    this->Collisions = static_cast<CollisionMode>(fields[5]);
+    this->Ticks = static_cast<unsigned int>(fields[6]);
+    std::memcpy(&this->TickRate, &rate, sizeof(rate));
+    this->Events.assign(data.begin() + cursor, data.end());
+    return true;
+}
+
+InputPlayback::InputPlayback(const InputRecording& recording)
+    : recording(recording), cursor(0), tick(0), nextChange(0), keys(0)
+{
+    this->readDelta();
+}
+
+void InputPlayback::readDelta()
+{
+    uint64_t delta;
+    if (this->cursor + 1 < this->recording.Events.size() && ReadVarint(this->recording.Events, this->cursor, delta))
+        this->nextChange += static_cast<unsigned int>(delta);
+    else
+        this->nextChange = this->recording.Ticks; // no more changes
+}
+
+unsigned int InputPlayback::Next()
+{
+    if (this->tick == this->nextChange && this->cursor < this->recording.Events.size())
+    {
+        this->keys = this->recording.Events[this->cursor++];
+        this->readDelta();
+    }
+    ++this->tick;
+    return this->keys;
+}
@@ -0,0 +1,66 @@
+#ifndef INPUT_RECORDING_H
+#define INPUT_RECORDING_H
+
+#include <cstdint>
+#include <vector>
+
+#include "simulation.h"
+
+// InputRecording is a session's worth of game keys (GameKey bits), one
+// mask per simulation tick, plus everything needed to start an identical
+// simulation. Masks only change when a key goes down or up, so the ticks
+// are stored as events: the number of ticks since the previous change as a
+// LEB128 varint, followed by the new mask in one byte. A minute of play
+// usually takes a few hundred bytes.
+//
+// file layout: "BKRP", version byte, then varints for seed, width, height,
+// start level, serve balls, collision mode and tick count, the tick rate
+// as 8 little endian bytes of a double, and the events up to the end.
+class InputRecording
+{
+public:
+    // how the recorded session started
+    uint64_t     Seed;
+    unsigned int Width, Height;
+    unsigned int Level;
+    unsigned int ServeBalls;
+    CollisionMode Collisions;
+    double       TickRate;
+    // recorded ticks
+    unsigned int Ticks;
+    std::vector<unsigned char> Events;
+    // constructor
+    InputRecording();
+    // copies the start conditions of the simulation, which must be fresh from Game::Init or Start
+    void Begin(const Simulation& sim, uint64_t seed, double tickRate);
+    // appends the keys held during the next tick
+    void Record(unsigned int keys);
+    // sets up a simulation the way the recorded session started
+    void Start(Simulation& sim) const;
+    // length of one recorded tick, exactly as the recording client computed it
+    float TickLength() const;
+    bool Save(const char* file) const;
+    bool Load(const char* file);
+private:
+    unsigned int lastKeys, lastChange;
+};
+
+// InputPlayback hands out the recorded key masks tick by tick.
+class InputPlayback
+{
+public:
+    // constructor
+    InputPlayback(const InputRecording& recording);
+    // whether every recorded tick was played
+    bool Done() const { return this->tick >= this->recording.Ticks; }
+    // keys held during the next tick
+    unsigned int Next();
+private:
+    const InputRecording& recording;
+    size_t       cursor;        // next unread byte of the events
+    unsigned int tick, nextChange, keys;
+    // reads the tick of the next change, or leaves it past the end when there is none
+    void readDelta();
+};
+
+#endif
@@ -0,0 +1,162 @@
+#include "level_catalog.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#include "level_file.h"
+
+// whether a directory entry is a level file the catalog lists
+static bool IsLevelFile(const std::filesystem::directory_entry& entry)
+{
+    std::error_code error;
+    std::string extension = entry.path().extension().string();
+    return entry.is_regular_file(error) && (extension == ".lvl" || extension == ".lvb");
+}
+
+// a catalog entry for a level file; compiled ones get their header read
+static LevelCatalog::Entry DescribeLevel(const std::filesystem::directory_entry& entry, const std::string& pack)
+{
+    std::error_code error;
+    LevelCatalog::Entry level{ entry.path().generic_string(), pack, entry.file_size(error), 0, 0, 0 };
+    if (entry.path().extension() != ".lvb")
+        return level;
+    LevelFileHeader header;
+    std::ifstream file(entry.path(), std::ios::binary);
+    if (file.read(reinterpret_cast<char*>(&header), sizeof(header)) && HasCompiledMagic(reinterpret_cast<const unsigned char*>(&header), sizeof(header))
+        && header.Version == LEVEL_FILE_VERSION && CompiledLevelSize(header) == level.Bytes)
+    {
+        level.Width = header.Width;
+        level.Height = header.Height;
+        level.Bricks = header.Bricks;
+    }
+    return level;
+}
+
+LevelCatalog::LevelCatalog(unsigned int levelWidth, unsigned int levelHeight)
+    : levelWidth(levelWidth), levelHeight(levelHeight), requested(-1), loading(-1), stale(false), stopping(false)
+{
+    this->thread = std::thread(&LevelCatalog::run, this);
+}
+
+LevelCatalog::~LevelCatalog()
+{
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        this->stopping = true;
+    }
+    this->wake.notify_all();
+    this->thread.join();
+}
+
+void LevelCatalog::Scan(const std::string& directory, const std::vector<std::string>& first)
+{
+    namespace fs = std::filesystem;
+    std::vector<Entry> found;
+    std::error_code error;
+    // the directory itself and one level of packs below it; only directory entries and compiled headers are read
+    for (fs::directory_iterator it(directory, error), end; !error && it != end; it.increment(error))
+    {
+        if (IsLevelFile(*it))
+            found.push_back(DescribeLevel(*it, ""));
+        else if (it->is_directory(error))
+        {
+            std::string pack = it->path().filename().string();
+            std::error_code packError;
+            for (fs::directory_iterator level(it->path(), packError); !packError && level != end; level.increment(packError))
+                if (IsLevelFile(*level))
+                    found.push_back(DescribeLevel(*level, pack));
+        }
+    }
+    std::sort(found.begin(), found.end(), [](const Entry& a, const Entry& b) { return a.File < b.File; });
+    std::vector<Entry> entries;
+    for (const std::string& file : first)
+    {
+        auto match = std::find_if(found.begin(), found.end(), [&](const Entry& entry) { return entry.File == file; });
+        if (match == found.end())
+            continue;
+        entries.push_back(*match);
+        found.erase(match);
+    }
+    entries.insert(entries.end(), found.begin(), found.end());
+    // the loader thread reads entries, so they only change while it is idle
+    std::unique_lock<std::mutex> guard(this->lock);
+    this->requested = -1;
+    this->finished.wait(guard, [this] { return this->loading < 0; });
+    this->done.clear();
+    this->entries.swap(entries);
+}
+
+void LevelCatalog::Prefetch(unsigned int level)
+{
+    std::lock_guard<std::mutex> guard(this->lock);
+    if (level >= this->entries.size() || static_cast<int>(level) == this->loading || this->done.count(level) > 0)
+        return;
+    this->requested = static_cast<int>(level);
+    this->wake.notify_all();
+}
+
+void LevelCatalog::Load(unsigned int level, GameLevel& into)
+{
+    std::unique_lock<std::mutex> guard(this->lock);
+    if (level >= this->entries.size())
+        return;
+    if (this->requested == static_cast<int>(level))
+        this->requested = -1;
+    this->finished.wait(guard, [&] { return this->loading != static_cast<int>(level); });
+    auto ready = this->done.find(level);
+    if (ready != this->done.end())
+    {
+        into = std::move(ready->second);
+        this->done.erase(ready);
+        return;
+    }
+    std::string file = this->entries[level].File;
+    guard.unlock();
+    into.Load(file.c_str(), this->levelWidth, this->levelHeight);
+}
+
+bool LevelCatalog::TakeLoaded(std::vector<std::pair<unsigned int, GameLevel>>& loaded)
+{
+    loaded.clear();
+    std::unique_lock<std::mutex> guard(this->lock, std::try_to_lock);
+    if (!guard.owns_lock() || this->done.empty())
+        return false;
+    for (auto& level : this->done)
+        loaded.emplace_back(level.first, std::move(level.second));
+    this->done.clear();
+    return true;
+}
+
+void LevelCatalog::Forget(const std::string& file)
+{
+    std::lock_guard<std::mutex> guard(this->lock);
+    for (auto level = this->done.begin(); level != this->done.end();)
+        level = this->entries[level->first].File == file ? this->done.erase(level) : std::next(level);
+    if (this->loading >= 0 && this->entries[this->loading].File == file)
+        this->stale = true;
+}
+
+void LevelCatalog::run()
+{
+    std::unique_lock<std::mutex> guard(this->lock);
+    for (;;)
+    {
+        this->wake.wait(guard, [this] { return this->stopping || this->requested >= 0; });
+        if (this->stopping)
+            return;
+        this->loading = this->requested;
+        this->requested = -1;
+        std::string file = this->entries[this->loading].File;
+        guard.unlock();
+        GameLevel level;
+        level.Load(file.c_str(), this->levelWidth, this->levelHeight);
+        guard.lock();
+        if (!this->stale)
+            this->done[this->loading] = std::move(level);
+        this->loading = -1;
+        this->stale = false;
+        this->finished.notify_all();
+    }
+}
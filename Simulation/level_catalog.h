@@ -0,0 +1,70 @@
+#ifndef LEVEL_CATALOG_H
+#define LEVEL_CATALOG_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "game_level.h"
+
+// LevelCatalog lists the level files installed in a directory without
+// reading their bricks, so startup costs the same however large the levels
+// are, and loads levels on demand. Of compiled levels it reads the fixed
+// size header for their dimensions and brick count; text levels would have
+// to be parsed for those, so only their file size is known up front. A loader thread reads levels ahead of
+// time, e.g. the one highlighted in the menu; loading a level that is on
+// its way waits for it instead of reading it twice. The catalog only hands
+// levels out, the Simulation decides which ones to keep.
+class LevelCatalog
+{
+public:
+    // a level file found by Scan
+    struct Entry {
+        std::string File;       // path of the file, the directory included
+        std::string Pack;       // subdirectory it was found in, empty for the directory itself
+        uintmax_t   Bytes;      // size of the file
+        // from the header of a compiled level; 0 for text levels and unreadable headers
+        unsigned int Width, Height, Bricks;
+    };
+    // constructor/destructor; levels are laid out in levelWidth x levelHeight pixels
+    LevelCatalog(unsigned int levelWidth, unsigned int levelHeight);
+    ~LevelCatalog();
+    LevelCatalog(const LevelCatalog&) = delete;
+    LevelCatalog& operator=(const LevelCatalog&) = delete;
+    // lists the text and compiled levels (.lvl and .lvb) of directory and of
+    // its subdirectories, the level packs. The files in first that exist come
+    // first in that order, the others follow sorted by path
+    void Scan(const std::string& directory, const std::vector<std::string>& first);
+    unsigned int Size() const { return static_cast<unsigned int>(this->entries.size()); }
+    const Entry& At(unsigned int level) const { return this->entries[level]; }
+    // has the loader thread read the level next, in place of the one asked for before
+    void Prefetch(unsigned int level);
+    // fills level with the given catalog level: the loader thread's copy
+    // when it has one or is reading it, otherwise read right here
+    void Load(unsigned int level, GameLevel& into);
+    // hands over the levels the loader thread finished since the last call,
+    // with their catalog index, replacing the contents of loaded; never waits
+    bool TakeLoaded(std::vector<std::pair<unsigned int, GameLevel>>& loaded);
+    // drops the loaded copies of a file that changed on disk, and the one
+    // being read, so the levels are read again the next time they are needed
+    void Forget(const std::string& file);
+private:
+    std::vector<Entry>                 entries;
+    unsigned int                       levelWidth, levelHeight;
+    std::map<unsigned int, GameLevel>  done;        // read by the loader thread, not yet handed over
+    int                                requested;   // level the loader thread is to read next, -1 for none
+    int                                loading;     // level the loader thread is reading, -1 for none
+    bool                               stale;       // the file being read changed since; its level is dropped
+    bool                               stopping;
+    std::mutex                         lock;        // guards everything the loader thread touches
+    std::condition_variable            wake, finished;
+    std::thread                        thread;
+    void run();
+};
+
+#endif
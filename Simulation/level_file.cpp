@@ -0,0 +1,163 @@
+#include "level_file.h"
+#include "mapped_file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+const char LEVEL_FILE_MAGIC[4] = { 'B', 'K', 'L', 'V' };
+
+uint64_t CompiledLevelSize(const LevelFileHeader& header)
+{
+    uint64_t bricks = header.Bricks;
+    return sizeof(LevelFileHeader) + (bricks + 63) / 64 * sizeof(uint64_t) + bricks * sizeof(uint32_t) + bricks
+        + static_cast<uint64_t>(header.Width) * header.Height;
+}
+
+bool HasCompiledMagic(const unsigned char* data, size_t size)
+{
+    return data && size >= sizeof(LEVEL_FILE_MAGIC) && std::memcmp(data, LEVEL_FILE_MAGIC, sizeof(LEVEL_FILE_MAGIC)) == 0;
+}
+
+bool IsCompiledLevel(const unsigned char* data, size_t size)
+{
+    if (!HasCompiledMagic(data, size) || size < sizeof(LevelFileHeader))
+        return false;
+    LevelFileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.Version != LEVEL_FILE_VERSION || CompiledLevelSize(header) != size || header.Bricks > static_cast<uint64_t>(header.Width) * header.Height)
+        return false;
+    // the loaders copy the sections as they are, so they have to agree with
+    // each other and hold no kind BrickStore can't index: level packs come from anywhere
+    size_t count = header.Bricks, tileCount = static_cast<size_t>(header.Width) * header.Height;
+    const unsigned char* solid = data + sizeof(header);
+    const unsigned char* cells = solid + (count + 63) / 64 * sizeof(uint64_t);
+    const unsigned char* kinds = cells + count * sizeof(uint32_t);
+    const unsigned char* tiles = kinds + count;
+    // every filled tile has its brick: the tiles are what hot reload and streaming read
+    size_t filled = 0;
+    for (size_t cell = 0; cell < tileCount; ++cell)
+    {
+        if (tiles[cell] > BRICK_KIND_MAX)
+            return false;
+        filled += tiles[cell] != 0;
+    }
+    if (filled != count)
+        return false;
+    uint32_t totalByKind[BRICK_KIND_MAX + 1] = {};
+    uint32_t previous = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t cell;
+        std::memcpy(&cell, cells + i * sizeof(uint32_t), sizeof(cell));
+        unsigned char kind = kinds[i];
+        bool isSolid = (solid[i / 8] >> (i % 8)) & 1;
+        // bricks are in row-major order, each in its own cell, with the tile's kind
+        if (cell >= tileCount || (i > 0 && cell <= previous) || kind == 0 || kind > BRICK_KIND_MAX
+            || tiles[cell] != kind || isSolid != (kind == BRICK_KIND_SOLID))
+            return false;
+        if (kind != BRICK_KIND_SOLID)
+            ++totalByKind[kind];
+        previous = cell;
+    }
+    return std::equal(totalByKind, totalByKind + BRICK_KIND_MAX + 1, header.TotalByKind);
+}
+
+bool ReadLevelText(const char* file, std::vector<std::vector<unsigned int>>& tiles)
+{
+    tiles.clear();
+    std::ifstream fstream(file);
+    if (!fstream)
+        return false;
+    unsigned int tileCode;
+    std::string line;
+    while (std::getline(fstream, line)) // read each line from level file
+    {
+        std::istringstream sstream(line);
+        std::vector<unsigned int> row;
+        while (sstream >> tileCode) // read each word separated by spaces
+            row.push_back(tileCode);
+        tiles.push_back(row);
+    }
+    return true;
+}
+
+bool ReadLevelTiles(const char* file, std::vector<std::vector<unsigned int>>& tiles)
+{
+    {
+        MappedFile compiled(file);
+        if (HasCompiledMagic(compiled.Data(), compiled.Size()))
+            return ReadCompiledTiles(compiled.Data(), compiled.Size(), tiles);
+    }
+    return ReadLevelText(file, tiles);
+}
+
+bool WriteLevelText(const char* file, const std::vector<std::vector<unsigned int>>& tiles)
+{
+    std::ofstream stream(file);
+    for (const std::vector<unsigned int>& row : tiles)
+    {
+        for (size_t x = 0; x < row.size(); ++x)
+            stream << (x > 0 ? " " : "") << row[x];
+        stream << "\n";
+    }
+    return static_cast<bool>(stream);
+}
+
+bool WriteCompiledLevel(const char* file, const std::vector<std::vector<unsigned int>>& tiles)
+{
+    LevelFileHeader header;
+    std::memcpy(header.Magic, LEVEL_FILE_MAGIC, sizeof(header.Magic));
+    header.Version = LEVEL_FILE_VERSION;
+    header.Height = static_cast<uint32_t>(tiles.size());
+    header.Width = tiles.empty() ? 0 : static_cast<uint32_t>(tiles[0].size());
+    header.Bricks = 0;
+    std::fill(header.TotalByKind, header.TotalByKind + BRICK_KIND_MAX + 1, 0u);
+    std::vector<unsigned char> kinds(static_cast<size_t>(header.Width) * header.Height, 0);
+    std::vector<uint32_t> cells;
+    for (uint32_t y = 0; y < header.Height; ++y)
+        for (uint32_t x = 0; x < header.Width && x < tiles[y].size(); ++x)
+            if (tiles[y][x] > 0)
+            {
+                unsigned char kind = static_cast<unsigned char>(tiles[y][x] > BRICK_KIND_MAX ? BRICK_KIND_MAX : tiles[y][x]);
+                uint32_t cell = y * header.Width + x;
+                kinds[cell] = kind;
+                cells.push_back(cell);
+                if (kind != BRICK_KIND_SOLID)
+                    ++header.TotalByKind[kind];
+            }
+    header.Bricks = static_cast<uint32_t>(cells.size());
+    std::vector<uint64_t> solid((cells.size() + 63) / 64, 0);
+    std::vector<unsigned char> brickKinds(cells.size());
+    for (size_t i = 0; i < cells.size(); ++i)
+    {
+        brickKinds[i] = kinds[cells[i]];
+        if (brickKinds[i] == BRICK_KIND_SOLID)
+            solid[i / 64] |= uint64_t(1) << (i % 64);
+    }
+    std::ofstream stream(file, std::ios::binary);
+    if (!stream)
+        return false;
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    stream.write(reinterpret_cast<const char*>(solid.data()), solid.size() * sizeof(uint64_t));
+    stream.write(reinterpret_cast<const char*>(cells.data()), cells.size() * sizeof(uint32_t));
+    stream.write(reinterpret_cast<const char*>(brickKinds.data()), brickKinds.size());
+    stream.write(reinterpret_cast<const char*>(kinds.data()), kinds.size());
+    return static_cast<bool>(stream);
+}
+
+bool ReadCompiledTiles(const unsigned char* data, size_t size, std::vector<std::vector<unsigned int>>& tiles)
+{
+    tiles.clear();
+    if (!IsCompiledLevel(data, size))
+        return false;
+    LevelFileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    const unsigned char* cells = data + size - static_cast<size_t>(header.Width) * header.Height;
+    tiles.resize(header.Height);
+    for (uint32_t y = 0; y < header.Height; ++y)
+        tiles[y].assign(cells + static_cast<size_t>(y) * header.Width, cells + static_cast<size_t>(y + 1) * header.Width);
+    return true;
+}
@@ -0,0 +1,56 @@
+#ifndef LEVEL_FILE_H
+#define LEVEL_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "brick_store.h"
+
+// Levels are written as text: one row of tiles per line, tile codes
+// separated by spaces, 0 for an empty cell. The level compiler turns them
+// into compiled level files, which GameLevel maps into memory and loads
+// in a single pass without parsing. A compiled level is laid out as
+// follows, little-endian, with the header a multiple of 8 bytes long:
+//
+//   LevelFileHeader
+//   uint64_t solid[(Bricks + 63) / 64]    bit i is set if brick i is solid
+//   uint32_t cells[Bricks]                tile cell y * Width + x of brick i, in row-major order
+//   uint8_t  kinds[Bricks]                BrickStore kind of brick i
+//   uint8_t  tiles[Width * Height]        kind of every tile cell, row by row, 0 when empty
+//
+// The brick table is what a level is loaded from; the tiles are kept so a
+// compiled level can be turned back into text. Brick positions depend on
+// the area the level is laid out in and are computed while loading.
+const uint32_t LEVEL_FILE_VERSION = 1;
+
+struct LevelFileHeader {
+    char     Magic[4];                          // "BKLV"
+    uint32_t Version;
+    uint32_t Width, Height;                     // in tiles
+    uint32_t Bricks;
+    uint32_t TotalByKind[BRICK_KIND_MAX + 1];   // breakable bricks of each kind
+};
+
+// bytes of a compiled level file with the given header
+uint64_t CompiledLevelSize(const LevelFileHeader& header);
+// whether data starts with the magic of a compiled level, of any version and
+// intact or not; such files are never read as text
+bool HasCompiledMagic(const unsigned char* data, size_t size);
+// whether data is a whole compiled level of the current version whose
+// brick table, solid bits, kind totals and tiles agree with each other
+bool IsCompiledLevel(const unsigned char* data, size_t size);
+// reads the rows of tile codes of a text level file; returns false if it can't be opened
+bool ReadLevelText(const char* file, std::vector<std::vector<unsigned int>>& tiles);
+// reads the rows of tile codes of a text or compiled level file; returns false if it can't be read
+bool ReadLevelTiles(const char* file, std::vector<std::vector<unsigned int>>& tiles);
+// writes rows of tile codes as a text level file; returns false if it can't be written
+bool WriteLevelText(const char* file, const std::vector<std::vector<unsigned int>>& tiles);
+// compiles rows of tile codes into a compiled level file; cells past the
+// first row's length are dropped and missing ones are empty, the way
+// GameLevel lays out text levels. Returns false if it can't be written
+bool WriteCompiledLevel(const char* file, const std::vector<std::vector<unsigned int>>& tiles);
+// turns the tile section of compiled level data back into rows of tile codes
+bool ReadCompiledTiles(const unsigned char* data, size_t size, std::vector<std::vector<unsigned int>>& tiles);
+
+#endif
@@ -0,0 +1,73 @@
+#include "level_generator.h"
+
+#include "brick_store.h"
+#include "pcg32.h"
+
+// Stream of the level generator's random generator, apart from the game's streams
+const uint64_t RNG_STREAM_LEVEL_GENERATOR = 4;
+
+void GenerateLevel(const LevelStyle& style, uint64_t seed, std::vector<std::vector<unsigned int>>& tiles)
+{
+    Pcg32 random(seed, RNG_STREAM_LEVEL_GENERATOR);
+    uint32_t fill = static_cast<uint32_t>(style.Fill * 65536.0f);
+    uint32_t solid = static_cast<uint32_t>(style.Solid * 65536.0f);
+    // mirrored levels draw the left half, middle column included, and copy it over
+    unsigned int columns = style.Mirrored ? (style.Width + 1) / 2 : style.Width;
+    tiles.assign(style.Height, std::vector<unsigned int>(style.Width, 0));
+    for (unsigned int y = 0; y < style.Height; ++y)
+    {
+        // bands of rows run from code 5 at the top down to 2 at the bottom
+        unsigned int band = 5 - y * 4 / style.Height;
+        for (unsigned int x = 0; x < columns; ++x)
+        {
+            unsigned int tile = 0;
+            if ((random.Next() >> 16) < fill)
+            {
+                if ((random.Next() >> 16) < solid)
+                    tile = BRICK_KIND_SOLID;
+                else
+                    tile = style.Banded ? band : 2 + random.Below(4);
+            }
+            tiles[y][x] = tile;
+            if (style.Mirrored)
+                tiles[y][style.Width - 1 - x] = tile;
+        }
+    }
+}
+
+unsigned int CountTrappedBricks(const std::vector<std::vector<unsigned int>>& tiles)
+{
+    if (tiles.empty())
+        return 0;
+    unsigned int height = static_cast<unsigned int>(tiles.size());
+    unsigned int width = static_cast<unsigned int>(tiles[0].size());
+    // flood the cells a ball can get to, starting from the open bottom row up;
+    // breakable bricks don't stop it since they can be destroyed on the way
+    std::vector<unsigned char> reached(width * height, 0);
+    std::vector<unsigned int> open;
+    for (unsigned int x = 0; x < width; ++x)
+        open.push_back((height - 1) * width + x);
+    while (!open.empty())
+    {
+        unsigned int cell = open.back();
+        open.pop_back();
+        unsigned int x = cell % width, y = cell / width;
+        unsigned int tile = x < tiles[y].size() ? tiles[y][x] : 0;
+        if (reached[cell] || tile == BRICK_KIND_SOLID)
+            continue;
+        reached[cell] = 1;
+        if (x > 0)
+            open.push_back(cell - 1);
+        if (x + 1 < width)
+            open.push_back(cell + 1);
+        if (y > 0)
+            open.push_back(cell - width);
+        if (y + 1 < height)
+            open.push_back(cell + width);
+    }
+    unsigned int trapped = 0;
+    for (unsigned int y = 0; y < height; ++y)
+        for (unsigned int x = 0; x < width && x < tiles[y].size(); ++x)
+            trapped += tiles[y][x] > BRICK_KIND_SOLID && !reached[y * width + x];
+    return trapped;
+}
@@ -0,0 +1,27 @@
+#ifndef LEVEL_GENERATOR_H
+#define LEVEL_GENERATOR_H
+
+#include <cstdint>
+#include <vector>
+
+// What generated levels look like. The defaults make levels the size and
+// look of the stock ones: mirrored halves, rows colored in bands with the
+// highest tile codes on top and a few solid bricks in between.
+struct LevelStyle {
+    unsigned int Width, Height;     // in tiles
+    float        Fill;              // fraction of the cells that hold a brick
+    float        Solid;             // fraction of the bricks that are solid
+    bool         Mirrored;          // the right half mirrors the left one
+    bool         Banded;            // rows of the same band share a color
+
+    LevelStyle() : Width(15), Height(8), Fill(0.8f), Solid(0.06f), Mirrored(true), Banded(true) { }
+};
+
+// generates the rows of tile codes of a level, 0 to 5 as GameLevel reads them;
+// the same style and seed always give the same level
+void GenerateLevel(const LevelStyle& style, uint64_t seed, std::vector<std::vector<unsigned int>>& tiles);
+// number of breakable bricks a ball can never reach because solid bricks
+// and the walls seal them off from the open space below the level
+unsigned int CountTrappedBricks(const std::vector<std::vector<unsigned int>>& tiles);
+
+#endif
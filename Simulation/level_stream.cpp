@@ -0,0 +1,47 @@
+#include "level_stream.h"
+
+#include <cstring>
+
+#include "brick_store.h"
+#include "level_file.h"
+#include "pcg32.h"
+
+void GeneratedRows::Row(uint64_t row, unsigned char* kinds) const
+{
+    Pcg32 random(this->seed, row);
+    // every fourth row is left open so balls find their way in between
+    if (row % 4 == 3)
+    {
+        std::memset(kinds, 0, this->columns);
+        return;
+    }
+    // from half the cells filled at the start to nine in ten a thousand rows in
+    uint32_t filled = static_cast<uint32_t>(row < 1000 ? 50 + row * 40 / 1000 : 90);
+    uint32_t solid = static_cast<uint32_t>(row < 1000 ? 2 + row * 6 / 1000 : 8);
+    for (unsigned int x = 0; x < this->columns; ++x)
+    {
+        if (random.Below(100) >= filled)
+            kinds[x] = 0;
+        else if (random.Below(100) < solid)
+            kinds[x] = BRICK_KIND_SOLID;
+        else
+            kinds[x] = static_cast<unsigned char>(2 + random.Below(BRICK_KIND_MAX - 2));
+    }
+}
+
+CompiledLevelRows::CompiledLevelRows(const char* file)
+    : file(file), tiles(nullptr), columns(0), rows(0)
+{
+    if (!IsCompiledLevel(this->file.Data(), this->file.Size()))
+        return;
+    LevelFileHeader header;
+    std::memcpy(&header, this->file.Data(), sizeof(header));
+    this->columns = header.Width;
+    this->rows = header.Height;
+    this->tiles = this->file.Data() + this->file.Size() - static_cast<size_t>(header.Width) * header.Height;
+}
+
+void CompiledLevelRows::Row(uint64_t row, unsigned char* kinds) const
+{
+    std::memcpy(kinds, this->tiles + (this->rows - 1 - row) * this->columns, this->columns);
+}
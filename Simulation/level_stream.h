@@ -0,0 +1,68 @@
+#ifndef LEVEL_STREAM_H
+#define LEVEL_STREAM_H
+
+#include <cstdint>
+#include <memory>
+
+#include "mapped_file.h"
+
+// Brick rows in a chunk, the unit a streamed level pages rows in and out by
+const unsigned int STREAM_CHUNK_ROWS = 8;
+// Chunks a streamed level keeps in memory; together they span more than the screen
+const unsigned int STREAM_CHUNKS = 4;
+// Rows a streamed level shows in the top half of the screen, as many as the stock levels have
+const unsigned int STREAM_VISIBLE_ROWS = 8;
+
+// ChunkSource hands out the brick rows of a streamed level by number; row
+// 0 scrolls in first, row 1 above it and so on. Rows must always come out
+// the same, whichever order they are asked for in, so a level can be
+// started over and copies of it stream alike. Sources are shared by the
+// copies of a level and never change once made.
+class ChunkSource
+{
+public:
+    virtual ~ChunkSource() { }
+    // bricks per row
+    virtual unsigned int Columns() const = 0;
+    // rows the level has, UINT64_MAX when it never ends
+    virtual uint64_t Rows() const = 0;
+    // writes the BrickStore kind of every cell of the row, 0 for empty ones
+    virtual void Row(uint64_t row, unsigned char* kinds) const = 0;
+};
+
+// Endless rows made up from a seed: every row is drawn from its own random
+// stream, so any row can be made without the ones before it. Bricks get
+// denser and solid ones more common the further the level goes.
+class GeneratedRows : public ChunkSource
+{
+public:
+    GeneratedRows(unsigned int columns, uint64_t seed) : columns(columns), seed(seed) { }
+    unsigned int Columns() const override { return this->columns; }
+    uint64_t Rows() const override { return UINT64_MAX; }
+    void Row(uint64_t row, unsigned char* kinds) const override;
+private:
+    unsigned int columns;
+    uint64_t     seed;
+};
+
+// The rows of a compiled level file (see level_file.h), read in place from
+// the mapped file, so even a level of millions of rows costs no more
+// memory than the pages being read. The file's last line scrolls in first,
+// so the level shows up the right way round.
+class CompiledLevelRows : public ChunkSource
+{
+public:
+    explicit CompiledLevelRows(const char* file);
+    // whether the file is a compiled level
+    bool IsOpen() const { return this->tiles != nullptr; }
+    unsigned int Columns() const override { return this->columns; }
+    uint64_t Rows() const override { return this->rows; }
+    void Row(uint64_t row, unsigned char* kinds) const override;
+private:
+    MappedFile           file;
+    const unsigned char* tiles;     // the tile section of the file
+    unsigned int         columns;
+    uint64_t             rows;
+};
+
+#endif
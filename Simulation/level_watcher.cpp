@@ -0,0 +1,122 @@
+#include "level_watcher.h"
+#include "level_file.h"
+
+#include <chrono>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+// Milliseconds the watcher thread sleeps between checks for stopping and, without inotify, between polls
+const int LEVEL_WATCH_INTERVAL = 100;
+
+// last modification time of a file, 0 if it doesn't exist
+static time_t ModificationTime(const std::string& file)
+{
+    struct stat info;
+    return stat(file.c_str(), &info) == 0 ? info.st_mtime : 0;
+}
+
+LevelWatcher::LevelWatcher(const std::vector<std::string>& paths)
+    : stopping(false), notify(-1)
+{
+    for (const std::string& path : paths)
+    {
+        if (path.empty())
+            continue;
+        WatchedFile file;
+        size_t slash = path.find_last_of("/\\");
+        file.Path = path;
+        file.Directory = slash == std::string::npos ? "." : path.substr(0, slash);
+        file.Name = slash == std::string::npos ? path : path.substr(slash + 1);
+        file.Watch = -1;
+        file.Modified = ModificationTime(path);
+        this->files.push_back(file);
+    }
+#ifdef __linux__
+    // editors often save by renaming a new file over the old one, which
+    // replaces the file's inode, so the directories are watched instead
+    this->notify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (this->notify >= 0)
+        for (WatchedFile& file : this->files)
+            file.Watch = inotify_add_watch(this->notify, file.Directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+#endif
+    this->thread = std::thread(&LevelWatcher::run, this);
+}
+
+LevelWatcher::~LevelWatcher()
+{
+    this->stopping = true;
+    this->thread.join();
+#ifdef __linux__
+    if (this->notify >= 0)
+        close(this->notify);
+#endif
+}
+
+bool LevelWatcher::TakeChanges(std::vector<Change>& changes)
+{
+    std::unique_lock<std::mutex> guard(this->lock, std::try_to_lock);
+    if (!guard.owns_lock() || this->pending.empty())
+        return false;
+    changes.swap(this->pending);
+    this->pending.clear();
+    return true;
+}
+
+void LevelWatcher::reload(const WatchedFile& file)
+{
+    Change change;
+    change.File = file.Path;
+    // a file caught half written reads short or not at all; the write that completes it brings another event
+    if (!ReadLevelTiles(file.Path.c_str(), change.Tiles) || change.Tiles.empty())
+        return;
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->pending.push_back(std::move(change));
+}
+
+void LevelWatcher::run()
+{
+    while (!this->stopping)
+    {
+#ifdef __linux__
+        if (this->notify >= 0)
+        {
+            pollfd ready = { this->notify, POLLIN, 0 };
+            if (poll(&ready, 1, LEVEL_WATCH_INTERVAL) <= 0)
+                continue;
+            // every file is read once, however many events a save caused
+            std::vector<bool> changed(this->files.size(), false);
+            alignas(inotify_event) char buffer[4096];
+            ssize_t size;
+            while ((size = read(this->notify, buffer, sizeof(buffer))) > 0)
+            {
+                for (char* next = buffer; next < buffer + size; )
+                {
+                    const inotify_event* event = reinterpret_cast<const inotify_event*>(next);
+                    next += sizeof(inotify_event) + event->len;
+                    for (unsigned int i = 0; i < this->files.size(); ++i)
+                        if (event->len > 0 && event->wd == this->files[i].Watch && this->files[i].Name == event->name)
+                            changed[i] = true;
+                }
+            }
+            for (unsigned int i = 0; i < this->files.size(); ++i)
+                if (changed[i])
+                    this->reload(this->files[i]);
+            continue;
+        }
+#endif
+        std::this_thread::sleep_for(std::chrono::milliseconds(LEVEL_WATCH_INTERVAL));
+        for (WatchedFile& file : this->files)
+        {
+            time_t modified = ModificationTime(file.Path);
+            if (modified != file.Modified)
+            {
+                file.Modified = modified;
+                this->reload(file);
+            }
+        }
+    }
+}
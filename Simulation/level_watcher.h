@@ -0,0 +1,51 @@
+#ifndef LEVEL_WATCHER_H
+#define LEVEL_WATCHER_H
+
+#include <atomic>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// LevelWatcher watches level files on a thread of its own and reads every
+// one that changes, so all the game has to do is patch the new tiles into
+// its levels. On Linux the thread sleeps on inotify events for the
+// directories of the files; elsewhere it compares modification times a
+// few times a second. Files that are saved by writing a new file and
+// renaming it over the old one are picked up too.
+class LevelWatcher
+{
+public:
+    // a level file that changed and the tiles read from it
+    struct Change {
+        std::string                            File;
+        std::vector<std::vector<unsigned int>> Tiles;
+    };
+    // constructor/destructor; starts and stops watching the given level files
+    explicit LevelWatcher(const std::vector<std::string>& files);
+    ~LevelWatcher();
+    LevelWatcher(const LevelWatcher&) = delete;
+    LevelWatcher& operator=(const LevelWatcher&) = delete;
+    // hands over the changes read since the last call in changes, replacing its contents, and returns
+    // whether there were any. Never waits: while the watcher thread is
+    // handing over a change this returns false and the change comes next time
+    bool TakeChanges(std::vector<Change>& changes);
+private:
+    struct WatchedFile {
+        std::string Path, Directory, Name;
+        int         Watch;          // inotify watch of the directory
+        time_t      Modified;       // last modification time seen when polling
+    };
+    std::vector<WatchedFile> files;
+    std::vector<Change>      pending;
+    std::mutex               lock;       // guards pending
+    std::atomic<bool>        stopping;
+    int                      notify;     // inotify descriptor, -1 when polling
+    std::thread              thread;
+    void run();
+    // reads a changed file and queues its tiles
+    void reload(const WatchedFile& file);
+};
+
+#endif
@@ -0,0 +1,68 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const char* file)
+    : data(nullptr), size(0), mapping(0)
+{
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(file, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+        return;
+    LARGE_INTEGER length;
+    if (GetFileSizeEx(handle, &length) && length.QuadPart > 0)
+    {
+        // the mapping keeps the file open, so the handle can go right away
+        HANDLE mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping)
+        {
+            void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if (view)
+            {
+                this->data = static_cast<const unsigned char*>(view);
+                this->size = static_cast<size_t>(length.QuadPart);
+                this->mapping = reinterpret_cast<intptr_t>(mapping);
+            }
+            else
+                CloseHandle(mapping);
+        }
+    }
+    CloseHandle(handle);
+#else
+    int descriptor = open(file, O_RDONLY);
+    if (descriptor < 0)
+        return;
+    struct stat status;
+    if (fstat(descriptor, &status) == 0 && status.st_size > 0)
+    {
+        void* view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (view != MAP_FAILED)
+        {
+            this->data = static_cast<const unsigned char*>(view);
+            this->size = static_cast<size_t>(status.st_size);
+        }
+    }
+    // the mapping stays valid after the descriptor is closed
+    close(descriptor);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+    if (!this->data)
+        return;
+#ifdef _WIN32
+    UnmapViewOfFile(this->data);
+    CloseHandle(reinterpret_cast<HANDLE>(this->mapping));
+#else
+    munmap(const_cast<unsigned char*>(this->data), this->size);
+#endif
+}
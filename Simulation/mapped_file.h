@@ -0,0 +1,27 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+
+// MappedFile maps a whole file read-only into memory for as long as it
+// lives, so a loader can parse it in place without reading it into
+// buffers first. Pages are only read from disk as they are touched.
+class MappedFile
+{
+public:
+    // constructor/destructor; an unreadable or empty file maps to nothing
+    explicit MappedFile(const char* file);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    // the file's bytes, or nullptr when it couldn't be mapped
+    const unsigned char* Data() const { return this->data; }
+    size_t Size() const { return this->size; }
+private:
+    const unsigned char* data;
+    size_t               size;
+    intptr_t             mapping;   // the file mapping HANDLE on Windows, unused elsewhere
+};
+
+#endif
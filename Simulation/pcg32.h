@@ -0,0 +1,54 @@
+#ifndef PCG32_H
+#define PCG32_H
+
+#include <cstdint>
+
+// Streams of the random generators owned by one game; generators with the
+// same seed but different streams produce independent sequences.
+const uint64_t RNG_STREAM_GAMEPLAY = 1;   // powerup spawns and anything else that changes the game
+const uint64_t RNG_STREAM_COSMETIC = 2;   // particles and other effects that must not
+
+// Pcg32 is the PCG-XSH-RR random generator: 64 bits of state, 32 bits of
+// output per step. It is small and cheap to copy, so every game owns its
+// generators and the whole game state can be saved and restored with them.
+class Pcg32
+{
+public:
+    // generator state
+    uint64_t State, Increment;
+    // constructor
+    Pcg32(uint64_t seed = 0, uint64_t stream = 0) { this->Seed(seed, stream); }
+    // restarts the sequence of the given stream at seed
+    void Seed(uint64_t seed, uint64_t stream)
+    {
+        this->State = 0;
+        this->Increment = (stream << 1) | 1;
+        this->Next();
+        this->State += seed;
+        this->Next();
+    }
+    // next 32 random bits
+    uint32_t Next()
+    {
+        uint64_t old = this->State;
+        this->State = old * 6364136223846793005ULL + this->Increment;
+        uint32_t xorshifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+        uint32_t rotation = static_cast<uint32_t>(old >> 59);
+        return (xorshifted >> rotation) | (xorshifted << ((32 - rotation) & 31));
+    }
+    // uniform in [0, bound), without modulo bias
+    uint32_t Below(uint32_t bound)
+    {
+        uint32_t threshold = (0u - bound) % bound;
+        for (;;)
+        {
+            uint32_t value = this->Next();
+            if (value >= threshold)
+                return value % bound;
+        }
+    }
+    // uniform in [0, 1)
+    double NextDouble() { return this->Next() * (1.0 / 4294967296.0); }
+};
+
+#endif
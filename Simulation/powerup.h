@@ -0,0 +1,50 @@
+//
+// Created by giovanni on 09/06/22.
+//
+
+#ifndef BREAKOUT_POWERUP_H
+#define BREAKOUT_POWERUP_H
+
+#include <glm/glm.hpp>
+
+#include "game_object.h"
+
+
+// The size of a PowerUp block
+const glm::vec2 POWERUP_SIZE(60.0f, 20.0f);
+// Velocity a PowerUp block has when spawned
+const glm::vec2 VELOCITY(0.0f, 150.0f);
+
+
+// The kinds of PowerUp; POWERUP_TABLE in simulation.h describes each one.
+// The order is the order drops are tried in when a brick is destroyed.
+enum PowerUpType : unsigned char {
+    POWERUP_SPEED,
+    POWERUP_STICKY,
+    POWERUP_PASS_THROUGH,
+    POWERUP_PAD_SIZE_INCREASE,
+    POWERUP_DEC_SPEED,
+    POWERUP_SLOWMO,
+    POWERUP_GHOST,
+    POWERUP_CONFUSE,
+    POWERUP_CHAOS,
+    POWERUP_DEATH,
+    POWERUP_MULTI_BALL,
+    POWERUP_TYPES
+};
+
+// PowerUp inherits its state and rendering functions from
+// GameObject but also holds the type of effect it gives once
+// caught. Caught effects are timed by EffectTimers.
+class PowerUp : public GameObject
+{
+public:
+    // powerup state
+    PowerUpType Type;
+    // constructor
+    PowerUp(PowerUpType type, glm::vec3 color, glm::vec2 position)
+            : GameObject(position, POWERUP_SIZE, color, VELOCITY), Type(type) { }
+};
+
+
+#endif //BREAKOUT_POWERUP_H
@@ -0,0 +1,238 @@
+#include "rollback_session.h"
+
+#include <chrono>
+#include <cstring>
+
+// Marks that no prediction turned out wrong
+const unsigned int NO_ROLLBACK = 0xffffffffu;
+// Ticks between the states whose checksums the peers compare
+const unsigned int SYNC_INTERVAL = 60;
+// Ticks one peer may run ahead of the other before it waits a tick
+const int TIME_SYNC_THRESHOLD = 2;
+// Fewest ticks between two waits, so the peer gets to see the effect of one
+const unsigned int TIME_SYNC_INTERVAL = 30;
+// Identifies versus packets
+const unsigned char PACKET_MAGIC[4] = { 'B', 'K', 'V', 'S' };
+// Size of a packet without its inputs
+const size_t PACKET_HEADER = 29;
+
+static void WriteWord(unsigned char* out, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i)
+        out[i] = static_cast<unsigned char>(value >> (8 * i));
+}
+
+static uint32_t ReadWord(const unsigned char* in)
+{
+    return uint32_t(in[0]) | uint32_t(in[1]) << 8 | uint32_t(in[2]) << 16 | uint32_t(in[3]) << 24;
+}
+
+// FNV-1a over raw bytes, continuing from hash
+static uint32_t Hash(uint32_t hash, const void* data, size_t size)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i)
+        hash = (hash ^ bytes[i]) * 16777619u;
+    return hash;
+}
+
+RollbackSession::RollbackSession(Simulation& sim, unsigned int localPlayer, unsigned int inputDelay, float tickLength)
+    : Sim(sim), LocalPlayer(localPlayer), InputDelay(inputDelay), TickLength(tickLength), Tick(0),
+      Rollbacks(0), RolledBackTicks(0), LongestRollback(0), SlowestRollbackMs(0.0), Stalls(0), Waits(0), Desynced(false), Failed(false),
+      inputs(), peerAck(inputDelay), rollbackTo(NO_ROLLBACK), localAdvantage(0), peerAdvantage(0), lastWait(0),
+      syncTicks(), syncHashes(), peerSyncTick(NO_ROLLBACK), peerSyncHash(0), saved(new SimSnapshot[ROLLBACK_WINDOW])
+{
+    // nobody presses anything during the first ticks, before the delayed keys arrive
+    this->known[PLAYER_ONE] = this->known[PLAYER_TWO] = inputDelay;
+    for (unsigned int& tick : this->syncTicks)
+        tick = NO_ROLLBACK;
+}
+
+bool RollbackSession::Advance(unsigned int keys)
+{
+    unsigned int remote = 1 - this->LocalPlayer;
+    if (this->Failed)
+        return false;
+    if (this->Tick >= this->known[remote] + MAX_PREDICTION)
+    {
+        ++this->Stalls;
+        return false;
+    }
+    // both peers measure how far they are ahead; the one further ahead skips a tick now and then
+    if ((this->localAdvantage - this->peerAdvantage) / 2 >= TIME_SYNC_THRESHOLD && this->Tick >= this->lastWait + TIME_SYNC_INTERVAL)
+    {
+        this->lastWait = this->Tick;
+        ++this->Waits;
+        return false;
+    }
+    unsigned int tick = this->known[this->LocalPlayer];
+    this->inputs[this->LocalPlayer][tick & (INPUT_HISTORY - 1)] = static_cast<unsigned char>(keys & (GAME_KEY_LEFT | GAME_KEY_RIGHT | GAME_KEY_LAUNCH));
+    this->known[this->LocalPlayer] = tick + 1;
+    this->Resolve();
+    if (this->Failed || !this->step(this->Tick))
+        return false;
+    ++this->Tick;
+    return true;
+}
+
+bool RollbackSession::Resolve()
+{
+    if (this->rollbackTo < this->Tick && !this->Failed)
+    {
+        auto start = std::chrono::steady_clock::now();
+        unsigned int depth = this->Tick - this->rollbackTo;
+        // the client gets the replayed ticks' sounds and particles from the first time round,
+        // so only the events the replay adds are dropped, not those of earlier ticks
+        unsigned int events = this->Sim.Events.Position();
+        this->saved[this->rollbackTo & (ROLLBACK_WINDOW - 1)].Restore(this->Sim);
+        for (unsigned int tick = this->rollbackTo; tick < this->Tick; ++tick)
+            if (!this->step(tick))
+                break;
+        this->Sim.Events.Rewind(events);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        ++this->Rollbacks;
+        this->RolledBackTicks += depth;
+        if (depth > this->LongestRollback)
+            this->LongestRollback = depth;
+        if (ms > this->SlowestRollbackMs)
+            this->SlowestRollbackMs = ms;
+    }
+    this->rollbackTo = NO_ROLLBACK;
+    // the state before a tick is final once the keys of all earlier ticks are known; it is
+    // still in the window since the session never predicts further than MAX_PREDICTION ticks
+    unsigned int confirmed = this->known[1 - this->LocalPlayer];
+    unsigned int last = confirmed < this->Tick ? confirmed : this->Tick - 1;
+    unsigned int tick = last - last % SYNC_INTERVAL;
+    unsigned int slot = (tick / SYNC_INTERVAL) & 7;
+    if (this->Tick > 0 && tick + ROLLBACK_WINDOW >= this->Tick && this->syncTicks[slot] != tick)
+    {
+        this->syncTicks[slot] = tick;
+        this->syncHashes[slot] = Checksum(this->saved[tick & (ROLLBACK_WINDOW - 1)]);
+        this->checkSync();
+    }
+    return confirmed >= this->Tick;
+}
+
+bool RollbackSession::step(unsigned int tick)
+{
+    unsigned int remote = 1 - this->LocalPlayer;
+    // a tick whose state wasn't saved could never be rolled back to; running
+    // it anyway would desync the first time a prediction for it is wrong
+    if (!this->saved[tick & (ROLLBACK_WINDOW - 1)].Save(this->Sim))
+    {
+        this->Failed = true;
+        return false;
+    }
+    // predict that the peer keeps holding the last keys it sent
+    if (tick >= this->known[remote])
+        this->inputs[remote][tick & (INPUT_HISTORY - 1)] = this->inputs[remote][(this->known[remote] - 1) & (INPUT_HISTORY - 1)];
+    SimInput one = PaddleInput(this->inputs[PLAYER_ONE][tick & (INPUT_HISTORY - 1)]);
+    SimInput two = PaddleInput(this->inputs[PLAYER_TWO][tick & (INPUT_HISTORY - 1)]);
+    this->Sim.StepVersus(this->TickLength, one, two);
+    return true;
+}
+
+void RollbackSession::checkSync()
+{
+    if (this->peerSyncTick == NO_ROLLBACK)
+        return;
+    unsigned int slot = (this->peerSyncTick / SYNC_INTERVAL) & 7;
+    if (this->syncTicks[slot] == this->peerSyncTick && this->syncHashes[slot] != this->peerSyncHash)
+        this->Desynced = true;
+}
+
+// packet layout, all words little endian:
+//   0  magic "BKVS"
+//   4  ticks of the receiver's keys the sender has
+//   8  sender's next tick
+//  12  sender's advantage: its tick minus the receiver's tick as last seen
+//  16  tick of the sender's latest checksum, or NO_ROLLBACK
+//  20  that checksum
+//  24  tick of the first keys in the packet
+//  28  number of keys, at most 255
+//  29  one GameKey mask per tick
+size_t RollbackSession::WritePacket(unsigned char* buffer, size_t capacity) const
+{
+    unsigned int remote = 1 - this->LocalPlayer;
+    unsigned int end = this->known[this->LocalPlayer];
+    unsigned int first = this->peerAck;
+    if (end - first > 255)
+        first = end - 255;
+    if (capacity < PACKET_HEADER + (end - first))
+        return 0;
+    // the latest checksum
+    unsigned int syncTick = NO_ROLLBACK;
+    uint32_t syncHash = 0;
+    for (unsigned int i = 0; i < 8; ++i)
+        if (this->syncTicks[i] != NO_ROLLBACK && (syncTick == NO_ROLLBACK || this->syncTicks[i] > syncTick))
+        {
+            syncTick = this->syncTicks[i];
+            syncHash = this->syncHashes[i];
+        }
+    std::memcpy(buffer, PACKET_MAGIC, 4);
+    WriteWord(buffer + 4, this->known[remote]);
+    WriteWord(buffer + 8, this->Tick);
+    WriteWord(buffer + 12, static_cast<uint32_t>(this->localAdvantage));
+    WriteWord(buffer + 16, syncTick);
+    WriteWord(buffer + 20, syncHash);
+    WriteWord(buffer + 24, first);
+    buffer[28] = static_cast<unsigned char>(end - first);
+    for (unsigned int tick = first; tick < end; ++tick)
+        buffer[PACKET_HEADER + tick - first] = this->inputs[this->LocalPlayer][tick & (INPUT_HISTORY - 1)];
+    return PACKET_HEADER + (end - first);
+}
+
+void RollbackSession::Receive(const unsigned char* data, size_t size)
+{
+    if (size < PACKET_HEADER || std::memcmp(data, PACKET_MAGIC, 4) != 0 || size < PACKET_HEADER + data[28])
+        return;
+    unsigned int remote = 1 - this->LocalPlayer;
+    unsigned int ack = ReadWord(data + 4);
+    if (ack > this->peerAck && ack <= this->known[this->LocalPlayer])
+        this->peerAck = ack;
+    // packets arrive late; the newest one wins
+    this->localAdvantage = static_cast<int>(this->Tick - ReadWord(data + 8));
+    this->peerAdvantage = static_cast<int>(ReadWord(data + 12));
+    unsigned int syncTick = ReadWord(data + 16);
+    if (syncTick != NO_ROLLBACK && (this->peerSyncTick == NO_ROLLBACK || syncTick > this->peerSyncTick))
+    {
+        this->peerSyncTick = syncTick;
+        this->peerSyncHash = ReadWord(data + 20);
+        this->checkSync();
+    }
+    // keys are taken in order only; the ones before are known already, a gap is filled by a later packet
+    unsigned int first = ReadWord(data + 24);
+    for (unsigned int i = 0; i < data[28]; ++i)
+    {
+        unsigned int tick = first + i;
+        if (tick < this->known[remote])
+            continue;
+        if (tick > this->known[remote])
+            break;
+        unsigned char keys = data[PACKET_HEADER + i];
+        unsigned char& slot = this->inputs[remote][tick & (INPUT_HISTORY - 1)];
+        // keys of ticks already run were predicted; roll back to the first wrong guess
+        if (tick < this->Tick && slot != keys && tick < this->rollbackTo)
+            this->rollbackTo = tick;
+        slot = keys;
+        this->known[remote] = tick + 1;
+    }
+}
+
+uint32_t RollbackSession::Checksum(const SimSnapshot& state)
+{
+    uint32_t hash = 2166136261u;
+    hash = Hash(hash, &state.Random, sizeof(state.Random));
+    hash = Hash(hash, &state.State, sizeof(state.State));
+    hash = Hash(hash, &state.Lives, sizeof(state.Lives));
+    hash = Hash(hash, &state.OpponentLives, sizeof(state.OpponentLives));
+    hash = Hash(hash, state.Scores, sizeof(state.Scores));
+    hash = Hash(hash, &state.Player.Position, sizeof(state.Player.Position));
+    hash = Hash(hash, &state.Opponent.Position, sizeof(state.Opponent.Position));
+    hash = Hash(hash, &state.BallCount, sizeof(state.BallCount));
+    hash = Hash(hash, state.BallPositions, state.BallCount * sizeof(glm::vec2));
+    hash = Hash(hash, state.BallVelocities, state.BallCount * sizeof(glm::vec2));
+    hash = Hash(hash, state.BricksDestroyed, (state.BrickCount + 63) / 64 * sizeof(uint64_t));
+    hash = Hash(hash, &state.PowerUpCount, sizeof(state.PowerUpCount));
+    return Hash(hash, &state.EffectCount, sizeof(state.EffectCount));
+}
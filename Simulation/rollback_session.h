@@ -0,0 +1,91 @@
+#ifndef ROLLBACK_SESSION_H
+#define ROLLBACK_SESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "simulation.h"
+#include "snapshot.h"
+
+// Ticks of saved game state a session can roll back over; a power of two
+const unsigned int ROLLBACK_WINDOW = 16;
+// Most ticks a session runs ahead of the last input it has from its peer
+const unsigned int MAX_PREDICTION = ROLLBACK_WINDOW - 1;
+// Ticks of input kept per player; a power of two well above the rollback window
+const unsigned int INPUT_HISTORY = 256;
+// Largest packet a session writes
+const unsigned int MAX_VERSUS_PACKET = 32 + 255;
+
+// RollbackSession runs one side of a networked versus game. Both peers
+// run the same deterministic Simulation; only the players' keys (GameKey
+// bits) travel over the network.
+//
+// Local keys are applied InputDelay ticks after they were read, which
+// hides that much latency outright. When a tick has to be simulated
+// before the peer's keys for it arrived, the session predicts that the
+// peer still holds its last known keys. Before every tick it saves a
+// snapshot. Once the real keys arrive and differ from the prediction it
+// restores the snapshot of the first mispredicted tick and simulates up
+// to the present again. A rollback goes back at most MAX_PREDICTION
+// ticks, because the session stalls rather than predict further ahead.
+//
+// Every packet carries all local keys the peer has not acknowledged yet,
+// so lost packets are repaired by the next one that arrives. Packets also
+// carry the sender's tick, to keep the two peers' clocks in step, and a
+// checksum of a state both peers agree on, to detect desyncs.
+class RollbackSession
+{
+public:
+    Simulation&  Sim;               // not owned; set up with StartVersus the same way on both peers
+    unsigned int LocalPlayer;       // PLAYER_ONE or PLAYER_TWO
+    unsigned int InputDelay;        // ticks between reading keys and applying them
+    float        TickLength;        // seconds per tick
+    unsigned int Tick;              // next tick to simulate
+    // statistics
+    unsigned int Rollbacks, RolledBackTicks, LongestRollback;
+    double       SlowestRollbackMs; // wall time of the slowest rollback, restore and resimulation included
+    unsigned int Stalls;            // ticks not run because the peer's keys were too far behind
+    unsigned int Waits;             // ticks not run to let the peer catch up
+    bool         Desynced;          // the peer reported a different state for a tick both agree on the input of
+    bool         Failed;            // a state didn't fit a snapshot and couldn't be rolled back to; no more ticks run
+    // constructor
+    RollbackSession(Simulation& sim, unsigned int localPlayer, unsigned int inputDelay, float tickLength);
+    // runs the next tick with the local keys, rolling back first if a
+    // prediction turned out wrong; returns false, without reading keys,
+    // when it has to wait for the peer instead or has Failed
+    bool Advance(unsigned int keys);
+    // rolls back if needed so that the present state is based on every
+    // key received so far; returns whether no tick ran on a prediction
+    bool Resolve();
+    // whether the peer acknowledged every local key sent so far
+    bool Delivered() const { return this->peerAck >= this->known[this->LocalPlayer]; }
+    // handles a packet from the peer
+    void Receive(const unsigned char* data, size_t size);
+    // writes the packet for the peer into buffer and returns its size
+    size_t WritePacket(unsigned char* buffer, size_t capacity) const;
+    // hash of the parts of a game state that must match on both peers
+    static uint32_t Checksum(const SimSnapshot& state);
+private:
+    // keys per player and tick; remote ticks not received yet hold the prediction they were run with
+    unsigned char inputs[2][INPUT_HISTORY];
+    unsigned int  known[2];         // per player, the keys of every tick below are known for sure
+    unsigned int  peerAck;          // local ticks the peer has received
+    unsigned int  rollbackTo;       // first tick run on a wrong prediction, or NO_ROLLBACK
+    int           localAdvantage, peerAdvantage;
+    unsigned int  lastWait;
+    // checksums of recent ticks whose inputs both peers know, and the peer's latest one
+    unsigned int  syncTicks[8];
+    uint32_t      syncHashes[8];
+    unsigned int  peerSyncTick;
+    uint32_t      peerSyncHash;
+    // the state before each of the last ROLLBACK_WINDOW ticks
+    std::unique_ptr<SimSnapshot[]> saved;
+    // saves the state and runs one tick with the known or predicted keys;
+    // sets Failed and returns false, without running it, if the state doesn't fit a snapshot
+    bool step(unsigned int tick);
+    // compares the peer's checksum with ours for the same tick, if we have it
+    void checkSync();
+};
+
+#endif
@@ -0,0 +1,897 @@
+#include "simulation.h"
+#include "collision.h"
+#include "collision_simd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+
+Simulation::Simulation(unsigned int width, unsigned int height)
+    : State(GAME_ACTIVE), Width(width), Height(height), LevelBudget(LEVEL_MEMORY_BUDGET), Level(0), Lives(3),
+      Player(glm::vec2(0.0f), PLAYER_SIZE), Balls(BALL_RADIUS), ServeBalls(1), Random(0, RNG_STREAM_GAMEPLAY),
+      Collisions(COLLISION_SWEPT), StepEvents(0),
+      Shake(false), Confuse(false), Chaos(false), SlowMo(false), ShakeTime(0.0f),
+      Versus(false), Opponent(glm::vec2(0.0f), PLAYER_SIZE), OpponentLives(3), Scores(), Serving(PLAYER_ONE), Winner(NO_WINNER),
+      KeysProcessed(0), tickSolidHit(false), useClock(0)
+{
+    float chances[POWERUP_TYPES];
+    for (unsigned int type = 0; type < POWERUP_TYPES; ++type)
+        chances[type] = POWERUP_TABLE[type].DropChance;
+    this->SetDropChances(chances);
+    this->ResetPlayer();
+}
+
+// The levels that came with the game; the catalog lists them first, in this order
+const char* const STOCK_LEVELS[] = { "levels/one.lvl", "levels/two.lvl", "levels/three.lvl", "levels/four.lvl" };
+
+void Simulation::LoadLevels()
+{
+    std::shared_ptr<LevelCatalog> catalog = std::make_shared<LevelCatalog>(this->Width, this->Height / 2);
+    catalog->Scan("levels", std::vector<std::string>(std::begin(STOCK_LEVELS), std::end(STOCK_LEVELS)));
+    this->UseCatalog(catalog);
+    this->LoadDropChances("powerups.cfg");
+    this->SelectLevel(0);
+    this->ResetPlayer();
+}
+
+void Simulation::UseCatalog(std::shared_ptr<LevelCatalog> catalog)
+{
+    this->Catalog = catalog;
+    this->Levels.assign(catalog->Size(), GameLevel());
+    this->LevelFiles.clear();
+    for (unsigned int i = 0; i < catalog->Size(); ++i)
+        this->LevelFiles.push_back(catalog->At(i).File);
+    this->levelUses.assign(catalog->Size(), 0);
+    this->Level = 0;
+}
+
+void Simulation::SelectLevel(unsigned int level)
+{
+    this->Level = level;
+    this->loadLevel(level);
+}
+
+void Simulation::AdoptLoadedLevels()
+{
+    if (!this->Catalog)
+        return;
+    std::vector<std::pair<unsigned int, GameLevel>> loaded;
+    if (!this->Catalog->TakeLoaded(loaded))
+        return;
+    // a level is the same however it got loaded, so when it arrives doesn't change how the game plays
+    for (std::pair<unsigned int, GameLevel>& level : loaded)
+        if (level.first < this->levelUses.size() && this->levelUses[level.first] == 0)
+        {
+            this->Levels[level.first] = std::move(level.second);
+            this->levelUses[level.first] = ++this->useClock;
+        }
+    this->evictLevels();
+}
+
+void Simulation::loadLevel(unsigned int level)
+{
+    if (level >= this->levelUses.size())
+        return;
+    bool loaded = this->levelUses[level] > 0;
+    this->levelUses[level] = ++this->useClock;
+    if (loaded)
+        return;
+    this->Catalog->Load(level, this->Levels[level]);
+    this->evictLevels();
+}
+
+void Simulation::evictLevels()
+{
+    // the level being played never counts against the budget and is never evicted
+    for (;;)
+    {
+        size_t bytes = 0;
+        int oldest = -1;
+        for (unsigned int i = 0; i < this->levelUses.size(); ++i)
+        {
+            if (this->levelUses[i] == 0 || i == this->Level)
+                continue;
+            bytes += this->Levels[i].Footprint();
+            if (oldest < 0 || this->levelUses[i] < this->levelUses[oldest])
+                oldest = i;
+        }
+        if (bytes <= this->LevelBudget)
+            return;
+        this->Levels[oldest] = GameLevel();
+        this->levelUses[oldest] = 0;
+    }
+}
+
+unsigned int Simulation::ReloadLevel(const std::string& file, const std::vector<std::vector<unsigned int>>& tiles)
+{
+    unsigned int changed = 0;
+    // catalog levels that aren't loaded will be read as they are now once they are
+    // needed; copies read ahead of time hold the old tiles and have to go
+    if (this->Catalog)
+        this->Catalog->Forget(file);
+    for (unsigned int i = 0; i < this->LevelFiles.size() && i < this->Levels.size(); ++i)
+        if (this->LevelFiles[i] == file && (i >= this->levelUses.size() || this->levelUses[i] > 0))
+            changed += this->Levels[i].Patch(tiles, this->Width, this->Height / 2);
+    return changed;
+}
+
+unsigned int Simulation::AddStreamedLevel(std::shared_ptr<const ChunkSource> source, float scrollSpeed)
+{
+    // rows as high as those of the stock levels, the first one resting where theirs end
+    GameLevel level;
+    level.Stream(source, this->Width, this->Height / 2.0f / STREAM_VISIBLE_ROWS, this->Height / 2.0f);
+    level.ScrollSpeed = scrollSpeed;
+    this->Levels.push_back(level);
+    this->LevelFiles.resize(this->Levels.size());
+    return static_cast<unsigned int>(this->Levels.size() - 1);
+}
+
+glm::vec2 Simulation::levelOrigin() const
+{
+    // versus leaves a quarter of the screen in front of each paddle
+    return this->Versus ? glm::vec2(0.0f, this->Height / 4.0f) : glm::vec2(0.0f);
+}
+
+void Simulation::Restart()
+{
+    this->ResetLevel();
+    this->OpponentLives = this->Lives;
+    this->Scores[PLAYER_ONE] = this->Scores[PLAYER_TWO] = 0;
+    this->Serving = PLAYER_ONE;
+    this->Winner = NO_WINNER;
+    // effects are dropped without running their Deactivate; ResetPlayer undoes what they did to paddle and balls
+    this->PowerUps.clear();
+    this->Effects.Clear();
+    this->Balls.Sticky = this->Balls.PassThrough = this->Balls.Ghost = false;
+    this->Balls.Color = glm::vec3(1.0f);
+    this->Shake = this->Confuse = this->Chaos = this->SlowMo = false;
+    this->ShakeTime = 0.0f;
+    this->State = GAME_ACTIVE;
+    this->ResetPlayer();
+}
+
+void Simulation::StartVersus(unsigned int level)
+{
+    this->Versus = true;
+    this->Collisions = COLLISION_SWEPT;
+    this->Level = level;
+    this->Restart();
+}
+
+void Simulation::StepVersus(float dt, SimInput one, SimInput two)
+{
+    this->ProcessInput(dt, one, PLAYER_ONE);
+    this->ProcessInput(dt, two, PLAYER_TWO);
+    this->Update(dt);
+}
+
+void Simulation::Seed(uint64_t seed)
+{
+    this->Random.Seed(seed, RNG_STREAM_GAMEPLAY);
+}
+
+void Simulation::Step(float dt, SimInput input)
+{
+    this->ProcessInput(dt, input);
+    this->Update(dt);
+}
+
+void Simulation::ProcessKeys(float dt, unsigned int keys)
+{
+    // released keys may be handled again
+    this->KeysProcessed &= keys;
+    if (this->State == GAME_WIN)
+    {
+        if (keys & GAME_KEY_CONFIRM)
+        {
+            this->KeysProcessed |= GAME_KEY_CONFIRM;
+            this->Chaos = false;
+            this->State = GAME_MENU;
+        }
+    }
+    if (this->State == GAME_ACTIVE)
+        this->ProcessInput(dt, PaddleInput(keys));
+    if (this->State == GAME_MENU)
+    {
+        unsigned int pressed = keys & ~this->KeysProcessed;
+        if (pressed & GAME_KEY_CONFIRM)
+        {
+            this->loadLevel(this->Level);
+            this->State = GAME_ACTIVE;
+        }
+        unsigned int levels = static_cast<unsigned int>(this->Levels.size());
+        if ((pressed & GAME_KEY_NEXT_LEVEL) && levels > 0)
+            this->Level = (this->Level + 1) % levels;
+        if ((pressed & GAME_KEY_PREV_LEVEL) && levels > 0)
+            this->Level = (this->Level + levels - 1) % levels;
+        // the highlighted level loads in the background while it is looked at
+        if ((pressed & (GAME_KEY_NEXT_LEVEL | GAME_KEY_PREV_LEVEL)) && this->Level < this->levelUses.size() && this->levelUses[this->Level] == 0)
+            this->Catalog->Prefetch(this->Level);
+        this->KeysProcessed |= pressed & (GAME_KEY_CONFIRM | GAME_KEY_NEXT_LEVEL | GAME_KEY_PREV_LEVEL);
+    }
+}
+
+void Simulation::ProcessInput(float dt, SimInput input, unsigned int player)
+{
+    if (this->State != GAME_ACTIVE)
+        return;
+    GameObject& paddle = this->Paddle(player);
+    float velocity = PLAYER_VELOCITY * dt;
+    // move playerboard
+    if (input.Left)
+    {
+        if (paddle.Position.x >= 0.0f)
+        {
+            paddle.Position.x -= velocity;
+            this->moveStuckBalls(player, -velocity);
+        }
+    }
+    if (input.Right)
+    {
+        if (paddle.Position.x <= this->Width - paddle.Size.x)
+        {
+            paddle.Position.x += velocity;
+            this->moveStuckBalls(player, velocity);
+        }
+    }
+    if (input.Launch)
+    {
+        for (unsigned int i = 0; i < this->Balls.Size(); ++i)
+            if (this->Balls.Owners[i] == player)
+                this->Balls.Stuck.Reset(i);
+    }
+}
+
+void Simulation::moveStuckBalls(unsigned int player, float dx)
+{
+    for (unsigned int i = 0; i < this->Balls.Size(); ++i)
+        if (this->Balls.Stuck.Test(i) && this->Balls.Owners[i] == player)
+            this->Balls.Positions[i].x += dx;
+}
+
+void Simulation::Update(float dt)
+{
+    this->Events.BeginTick();
+    this->tickBreaks.clear();
+    this->tickSolidHit = false;
+    if (this->State == GAME_ACTIVE && this->Levels[this->Level].IsCompleted())
+    {
+        if (this->Versus)
+        {   // most bricks wins; the board stays as it is for the result screen
+            unsigned int one = this->Scores[PLAYER_ONE], two = this->Scores[PLAYER_TWO];
+            this->Winner = one > two ? PLAYER_ONE : two > one ? PLAYER_TWO : NO_WINNER;
+        }
+        else
+        {
+            this->ResetLevel();
+            this->ResetPlayer();
+        }
+        this->Chaos = true;
+        this->State = GAME_WIN;
+    }
+    if (this->State == GAME_ACTIVE || this->State == GAME_MENU)
+    {
+        if (this->Collisions == COLLISION_SWEPT)
+        {
+            this->SweepBalls(dt);
+            this->catchPowerUps();
+        }
+        else
+        {
+            this->Balls.Move(dt, this->Width);
+            this->DoCollisions();
+        }
+        this->applyEvents();
+        // balls below the bottom edge (or, in versus, above the top one) are out of
+        // play; the last one costs a life to the player on whose side it left
+        unsigned int lostBy = PLAYER_ONE;
+        for (unsigned int i = this->Balls.Size(); i-- > 0; )
+        {
+            if (this->Balls.Positions[i].y >= this->Height)
+            {
+                lostBy = PLAYER_ONE;
+                this->Balls.Remove(i);
+            }
+            else if (this->Versus && this->Balls.Positions[i].y + this->Balls.Radius * 2.0f <= 0.0f)
+            {
+                lostBy = PLAYER_TWO;
+                this->Balls.Remove(i);
+            }
+        }
+        if (this->Balls.Size() == 0)
+            this->loseLife(lostBy);
+        // streamed levels move down towards the paddle, and letting bricks get there costs a life
+        if (this->State == GAME_ACTIVE && this->Levels[this->Level].IsStreamed())
+        {
+            GameLevel& level = this->Levels[this->Level];
+            if (level.Scroll(level.ScrollSpeed * dt, this->Player.Position.y) > 0)
+                this->loseLife(PLAYER_ONE);
+        }
+        this->UpdatePowerUps(dt);
+        if (this->ShakeTime > 0.0f)
+        {
+            this->ShakeTime -= dt;
+            if (this->ShakeTime <= 0.0f)
+                this->Shake = false;
+        }
+    }
+}
+
+void Simulation::loseLife(unsigned int player)
+{
+    unsigned int& lives = player == PLAYER_TWO ? this->OpponentLives : this->Lives;
+    --lives;
+    if (lives == 0)
+    {
+        if (this->Versus)
+        {   // the other player wins; the board stays as it is for the result screen
+            this->Winner = PLAYER_TWO - player;
+            this->State = GAME_WIN;
+            return;
+        }
+        this->ResetLevel();
+        this->State = GAME_MENU;
+    }
+    this->Serving = player;
+    this->ResetPlayer();
+}
+
+void Simulation::ResetLevel()
+{
+    this->Lives = 3;
+    this->loadLevel(this->Level);
+    if (this->Level < this->Levels.size())
+        this->Levels[this->Level].Reset(this->levelOrigin());
+}
+
+// rotates a velocity by angle radians
+glm::vec2 RotateVelocity(glm::vec2 velocity, float angle)
+{
+    float c = std::cos(angle), s = std::sin(angle);
+    return glm::vec2(velocity.x * c - velocity.y * s, velocity.x * s + velocity.y * c);
+}
+
+void Simulation::ResetPlayer()
+{
+    this->Player.Size = PLAYER_SIZE;
+    this->Player.Position = glm::vec2(this->Width / 2.0f - PLAYER_SIZE.x / 2.0f, this->Height - PLAYER_SIZE.y);
+    glm::vec2 position = this->Player.Position + glm::vec2(PLAYER_SIZE.x / 2.0f - BALL_RADIUS, -(BALL_RADIUS * 2.0f));
+    glm::vec2 velocity = INITIAL_BALL_VELOCITY;
+    if (this->Versus)
+    {
+        this->Opponent.Size = PLAYER_SIZE;
+        this->Opponent.Position = glm::vec2(this->Width / 2.0f - PLAYER_SIZE.x / 2.0f, 0.0f);
+        if (this->Serving == PLAYER_TWO)
+        {   // serve downwards from under the top paddle
+            position = this->Opponent.Position + glm::vec2(PLAYER_SIZE.x / 2.0f - BALL_RADIUS, PLAYER_SIZE.y);
+            velocity.y = -velocity.y;
+        }
+    }
+    unsigned int count = std::max(this->ServeBalls, 1u);
+    this->Balls.Clear();
+    for (unsigned int i = 0; i < count; ++i)
+    {   // extra balls fan out around the initial direction
+        float angle = (i - (count - 1) / 2.0f) * SERVE_SPREAD / count;
+        this->Balls.Add(position, RotateVelocity(velocity, angle), true, static_cast<unsigned char>(this->Serving));
+    }
+}
+
+void Simulation::SplitBalls()
+{
+    BallPool& balls = this->Balls;
+    unsigned int count = balls.Size();
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        for (float angle : { -MULTI_BALL_SPREAD, MULTI_BALL_SPREAD })
+        {
+            unsigned int added = balls.Add(balls.Positions[i], RotateVelocity(balls.Velocities[i], angle), balls.Stuck.Test(i), balls.Owners[i]);
+            if (added == MAX_BALLS)
+                return;
+            balls.OldVelocities[added] = RotateVelocity(balls.OldVelocities[i], angle);
+        }
+    }
+}
+
+// The effects of the powerups, as hooked into POWERUP_TABLE. Activate runs
+// before the timer of the caught powerup starts, so checks for running
+// effects of the same type don't see it.
+struct PowerUpEffects
+{
+    static void Speed(Simulation& sim, unsigned int)
+    {
+        for (glm::vec2& velocity : sim.Balls.Velocities)
+            velocity *= 1.2f;
+    }
+    static void Sticky(Simulation& sim, unsigned int player)
+    {
+        sim.Balls.Sticky = true;
+        sim.Paddle(player).Color = glm::vec3(1.0f, 0.5f, 1.0f);
+    }
+    static void EndSticky(Simulation& sim)
+    {
+        sim.Balls.Sticky = false;
+        sim.Player.Color = glm::vec3(1.0f);
+        sim.Opponent.Color = glm::vec3(1.0f);
+    }
+    static void PassThrough(Simulation& sim, unsigned int)
+    {
+        sim.Balls.PassThrough = true;
+        if (sim.Effects.IsActive(POWERUP_SLOWMO) && sim.Effects.IsActive(POWERUP_GHOST))
+            sim.Balls.Color = glm::vec3(0.5f, 0.6f, 0.7f);
+        else if (sim.Effects.IsActive(POWERUP_SLOWMO))
+            sim.Balls.Color = glm::vec3(0.5f, 0.5f, 0.7f);
+        else if (sim.Effects.IsActive(POWERUP_GHOST))
+            sim.Balls.Color = glm::vec3(0.7f, 0.5f, 0.5f);
+        else
+            sim.Balls.Color = glm::vec3(1.0f, 0.5f, 0.5f);
+    }
+    static void EndPassThrough(Simulation& sim)
+    {
+        sim.Balls.PassThrough = false;
+        sim.Balls.Color = glm::vec3(1.0f);
+    }
+    static void PadSizeIncrease(Simulation& sim, unsigned int player)
+    {
+        sim.Paddle(player).Size.x += 50;
+    }
+    static void DecSpeed(Simulation& sim, unsigned int)
+    {
+        for (glm::vec2& velocity : sim.Balls.Velocities)
+            velocity *= 0.8f;
+    }
+    static void SlowMo(Simulation& sim, unsigned int)
+    {
+        if (sim.Effects.IsActive(POWERUP_SLOWMO))
+            return;
+        BallPool& balls = sim.Balls;
+        for (unsigned int i = 0; i < balls.Size(); ++i)
+        {
+            glm::vec2& velocity = balls.Velocities[i];
+            glm::vec2& oldVelocity = balls.OldVelocities[i];
+            oldVelocity = velocity;
+            velocity.y = INITIAL_BALL_VELOCITY.y * 0.3f;
+            if (oldVelocity.y / std::abs(oldVelocity.y) != (velocity.y / std::abs(velocity.y)))
+                velocity.y *= -1;
+        }
+        if (sim.Effects.IsActive(POWERUP_GHOST) && sim.Effects.IsActive(POWERUP_PASS_THROUGH))
+            balls.Color = glm::vec3(0.5f, 0.6f, 0.7f);
+        else if (sim.Effects.IsActive(POWERUP_GHOST))
+            balls.Color = glm::vec3(0.2f, 0.6f, 0.7f);
+        else if (sim.Effects.IsActive(POWERUP_PASS_THROUGH))
+            balls.Color = glm::vec3(0.5f, 0.5f, 0.7f);
+        else
+            balls.Color = glm::vec3(0.0f, 0.6f, 1.0f);
+        sim.SlowMo = true;
+    }
+    static void EndSlowMo(Simulation& sim)
+    {
+        BallPool& balls = sim.Balls;
+        for (unsigned int i = 0; i < balls.Size(); ++i)
+        {
+            glm::vec2& velocity = balls.Velocities[i];
+            bool isNegative = false;
+            if (balls.OldVelocities[i].y / std::abs(balls.OldVelocities[i].y) != (velocity.y / std::abs(velocity.y)))
+                isNegative = true;
+            velocity.y = balls.OldVelocities[i].y;
+            if (isNegative)
+                velocity.y *= -1;
+        }
+        balls.Color = glm::vec3(1.0f);
+        sim.SlowMo = false;
+    }
+    static void Ghost(Simulation& sim, unsigned int)
+    {
+        sim.Balls.Ghost = true;
+        if (sim.Effects.IsActive(POWERUP_SLOWMO) && sim.Effects.IsActive(POWERUP_PASS_THROUGH))
+            sim.Balls.Color = glm::vec3(0.5f, 0.6f, 0.7f);
+        else if (sim.Effects.IsActive(POWERUP_SLOWMO))
+            sim.Balls.Color = glm::vec3(0.2f, 0.6f, 0.7f);
+        else if (sim.Effects.IsActive(POWERUP_PASS_THROUGH))
+            sim.Balls.Color = glm::vec3(0.7f, 0.5f, 0.5f);
+        else
+            sim.Balls.Color = glm::vec3(0.5f, 0.5f, 0.5f);
+    }
+    static void EndGhost(Simulation& sim)
+    {
+        sim.Balls.Ghost = false;
+    }
+    static void Confuse(Simulation& sim, unsigned int)
+    {
+        if (!sim.Chaos)
+            sim.Confuse = true; // only activate if chaos wasn't already active
+    }
+    static void EndConfuse(Simulation& sim)
+    {
+        sim.Confuse = false;
+    }
+    static void Chaos(Simulation& sim, unsigned int)
+    {
+        if (!sim.Confuse)
+            sim.Chaos = true;
+    }
+    static void EndChaos(Simulation& sim)
+    {
+        sim.Chaos = false;
+    }
+    static void Death(Simulation& sim, unsigned int player)
+    {
+        sim.loseLife(player);
+    }
+    static void MultiBall(Simulation& sim, unsigned int)
+    {
+        sim.SplitBalls();
+    }
+};
+
+// Indexed by PowerUpType
+const PowerUpDescriptor POWERUP_TABLE[POWERUP_TYPES] = {
+    { "speed",             "powerup_speed",       glm::vec3(0.5f, 0.5f, 1.0f),   0.0f, 1.33f, PowerUpEffects::Speed,           nullptr },
+    { "sticky",            "powerup_sticky",      glm::vec3(1.0f, 0.5f, 1.0f),  20.0f, 1.32f, PowerUpEffects::Sticky,          PowerUpEffects::EndSticky },
+    { "pass-through",      "powerup_passthrough", glm::vec3(0.5f, 1.0f, 0.5f),  10.0f, 1.30f, PowerUpEffects::PassThrough,     PowerUpEffects::EndPassThrough },
+    { "pad-size-increase", "powerup_increase",    glm::vec3(1.0f, 0.6f, 0.4f),   0.0f, 1.28f, PowerUpEffects::PadSizeIncrease, nullptr },
+    { "dec_speed",         "powerup_dec_speed",   glm::vec3(1.0f, 0.5f, 0.8f),   0.0f, 1.26f, PowerUpEffects::DecSpeed,        nullptr },
+    { "slowmo",            "powerup_slowmo",      glm::vec3(0.0f, 0.6f, 1.0f),  20.0f, 1.25f, PowerUpEffects::SlowMo,          PowerUpEffects::EndSlowMo },
+    { "ghost",             "powerup_ghost",       glm::vec3(0.5f, 0.5f, 0.5f),  20.0f, 1.23f, PowerUpEffects::Ghost,           PowerUpEffects::EndGhost },
+    { "confuse",           "powerup_confuse",     glm::vec3(1.0f, 0.3f, 0.3f),  15.0f, 3.64f, PowerUpEffects::Confuse,         PowerUpEffects::EndConfuse }, // negative powerups should spawn more often
+    { "chaos",             "powerup_chaos",       glm::vec3(0.9f, 0.25f, 0.25f), 15.0f, 3.50f, PowerUpEffects::Chaos,          PowerUpEffects::EndChaos },
+    { "death",             "powerup_death",       glm::vec3(1.0f, 0.1f, 0.1f),   0.0f, 1.12f, PowerUpEffects::Death,           nullptr },
+    { "multi-ball",        "powerup_multiball",   glm::vec3(1.0f, 0.9f, 0.4f),   0.0f, 1.10f, PowerUpEffects::MultiBall,       nullptr }
+};
+
+void Simulation::SetDropChances(const float chances[POWERUP_TYPES])
+{
+    // one more outcome for bricks that drop nothing
+    std::vector<double> weights(POWERUP_TYPES + 1);
+    double none = 100.0;
+    for (unsigned int type = 0; type < POWERUP_TYPES; ++type)
+    {
+        this->DropChances[type] = chances[type];
+        weights[type] = chances[type];
+        none -= chances[type];
+    }
+    weights[POWERUP_TYPES] = std::max(none, 0.0);
+    this->Drops.Build(weights);
+}
+
+bool Simulation::LoadDropChances(const char* file)
+{
+    std::ifstream stream(file);
+    if (!stream)
+        return false;
+    // powerups the file leaves out keep their default chance
+    float chances[POWERUP_TYPES];
+    for (unsigned int type = 0; type < POWERUP_TYPES; ++type)
+        chances[type] = POWERUP_TABLE[type].DropChance;
+    std::string line;
+    while (std::getline(stream, line))
+    {
+        std::istringstream words(line.substr(0, line.find('#')));
+        std::string name;
+        float chance;
+        if (!(words >> name))
+            continue; // blank or comment
+        if (!(words >> chance) || chance < 0.0f)
+            return false;
+        unsigned int type = 0;
+        while (type < POWERUP_TYPES && name != POWERUP_TABLE[type].Name)
+            ++type;
+        if (type == POWERUP_TYPES)
+            return false;
+        chances[type] = chance;
+    }
+    float total = 0.0f;
+    for (float chance : chances)
+        total += chance;
+    if (total > 100.0f)
+        return false;
+    this->SetDropChances(chances);
+    return true;
+}
+
+void Simulation::SpawnPowerUps(glm::vec2 position)
+{
+    unsigned int type = this->Drops.Sample(this->Random);
+    if (type < POWERUP_TYPES)
+        this->PowerUps.push_back(PowerUp(static_cast<PowerUpType>(type), POWERUP_TABLE[type].Color, position));
+}
+
+void Simulation::ActivatePowerUp(PowerUpType type, unsigned int player)
+{
+    const PowerUpDescriptor& descriptor = POWERUP_TABLE[type];
+    descriptor.Activate(*this, player);
+    if (descriptor.Duration > 0.0f)
+        this->Effects.Start(type, descriptor.Duration);
+}
+
+void Simulation::UpdatePowerUps(float dt)
+{
+    for (PowerUp &powerUp : this->PowerUps)
+        powerUp.Position += powerUp.Velocity * dt;
+    // deactivate effects, only once no other powerup of the type is running
+    this->Effects.Advance(dt, [this](PowerUpType type) {
+        if (POWERUP_TABLE[type].Deactivate)
+            POWERUP_TABLE[type].Deactivate(*this);
+    });
+    this->PowerUps.erase(std::remove_if(this->PowerUps.begin(), this->PowerUps.end(),
+                                        [](const PowerUp &powerUp) { return powerUp.Destroyed; }
+    ), this->PowerUps.end());
+}
+
+bool Simulation::hitBrick(unsigned int ball, unsigned int index)
+{
+    BrickStore& bricks = this->Levels[this->Level].Bricks;
+    bool solid = bricks.IsSolid(index);
+    // destroy block if not solid
+    if (!solid) {
+        bricks.Destroy(index);
+        this->tickBreaks.push_back(BrickBreak{ bricks.Positions[index], this->Balls.Owners[ball] });
+        this->Events.Push(EVENT_BRICK_DESTROYED, bricks.Positions[index], bricks.Kinds[index], this->Balls.Owners[ball]);
+    }
+    else if (!this->Balls.Ghost)
+    {
+        this->tickSolidHit = true;
+        this->Events.Push(EVENT_SOLID_HIT, bricks.Positions[index]);
+    }
+    return !(this->Balls.PassThrough && !solid) && !(this->Balls.Ghost && solid);
+}
+
+void Simulation::hitPaddle(unsigned int ball, unsigned int player)
+{
+    const GameObject& paddle = this->Paddle(player);
+    glm::vec2& velocity = this->Balls.Velocities[ball];
+    // check where it hit the board, and change velocity based on where it hit the board
+    float centerBoard = paddle.Position.x + paddle.Size.x / 2.0f;
+    float distance = (this->Balls.Positions[ball].x + this->Balls.Radius) - centerBoard;
+    float percentage = distance / (paddle.Size.x / 2.0f);
+    // then move accordingly
+    float strength = 2.0f;
+    glm::vec2 oldVelocity = velocity;
+    velocity.x = INITIAL_BALL_VELOCITY.x * percentage * strength;
+    velocity = glm::normalize(velocity) * glm::length(oldVelocity); // keep speed consistent over both axes (multiply by length of old velocity, so total strength is not changed)
+    // fix sticky paddle: send the ball away from the paddle, up from the bottom one and down from the top one
+    if (player == PLAYER_TWO)
+        velocity.y = std::abs(velocity.y);
+    else
+        velocity.y = -1.0f * std::abs(velocity.y);
+    this->Balls.Owners[ball] = static_cast<unsigned char>(player);
+
+    // if Sticky powerup is activated, also stick ball to paddle once new velocity vectors were calculated
+    if (this->Balls.Sticky)
+        this->Balls.Stuck.Set(ball);
+    else
+        this->Balls.Stuck.Reset(ball);
+    this->Events.Push(EVENT_PADDLE_HIT, this->Balls.Positions[ball], 0, static_cast<unsigned char>(player));
+}
+
+void Simulation::catchPowerUps()
+{
+    for (PowerUp &powerUp : this->PowerUps)
+    {
+        if (!powerUp.Destroyed)
+        {
+            if (powerUp.Position.y >= this->Height || powerUp.Position.y + powerUp.Size.y <= 0.0f)
+                powerUp.Destroyed = true;
+            unsigned int catcher = PLAYER_ONE;
+            bool caught = CheckCollision(this->Player, powerUp);
+            if (!caught && this->Versus && CheckCollision(this->Opponent, powerUp))
+            {
+                catcher = PLAYER_TWO;
+                caught = true;
+            }
+            if (caught)
+            {	// collided with player, now activate powerup
+                ActivatePowerUp(powerUp.Type, catcher);
+                this->Events.Push(EVENT_POWERUP_COLLECTED, powerUp.Position, powerUp.Type, static_cast<unsigned char>(catcher));
+                powerUp.Destroyed = true;
+            }
+        }
+    }
+}
+
+void Simulation::applyEvents()
+{
+    for (const BrickBreak& brick : this->tickBreaks)
+    {
+        ++this->Scores[brick.Player];
+        size_t spawned = this->PowerUps.size();
+        this->SpawnPowerUps(brick.Position);
+        // in versus, drops fall towards the player who broke the brick
+        if (brick.Player == PLAYER_TWO && this->PowerUps.size() > spawned)
+            this->PowerUps.back().Velocity.y = -this->PowerUps.back().Velocity.y;
+    }
+    if (this->tickSolidHit)
+    {
+        this->ShakeTime = 0.05f;
+        this->Shake = true;
+    }
+}
+
+void Simulation::collideBatch(unsigned int ball, const BrickBatch& batch)
+{
+    glm::vec2& position = this->Balls.Positions[ball];
+    glm::vec2& velocity = this->Balls.Velocities[ball];
+    float radius = this->Balls.Radius;
+    BatchContacts contacts;
+    unsigned int mask = CollideBatch(position + radius, radius, batch, contacts);
+    for (unsigned int lane = 0; lane < batch.Count && mask; ++lane)
+    {
+        if (!(mask & (1u << lane)))
+            continue;
+        // collision resolution
+        glm::vec2 diff_vector(contacts.X[lane], contacts.Y[lane]);
+        Direction dir = VectorDirection(diff_vector);
+        if (this->hitBrick(ball, batch.Indices[lane])) {
+            if (dir == LEFT || dir == RIGHT) // horizontal collision
+            {
+                velocity.x = -velocity.x; // reverse horizontal velocity
+                // relocate
+                float penetration = radius - std::abs(diff_vector.x);
+                if (dir == LEFT)
+                    position.x += penetration; // move ball to right
+                else
+                    position.x -= penetration; // move ball to left;
+            }
+            else // vertical collision
+            {
+                velocity.y = -velocity.y; // reverse vertical velocity
+                // relocate
+                float penetration = radius - std::abs(diff_vector.y);
+                if (dir == UP)
+                    position.y -= penetration; // move ball back up
+                else
+                    position.y += penetration; // move ball back down
+            }
+            // the ball moved: test the remaining lanes again from its new position
+            mask = CollideBatch(position + radius, radius, batch, contacts);
+        }
+        mask &= ~((2u << lane) - 1);
+    }
+}
+
+void Simulation::DoCollisions()
+{
+    GameLevel& level = this->Levels[this->Level];
+    BrickStore& bricks = level.Bricks;
+    float radius = this->Balls.Radius;
+    for (unsigned int ball = 0; ball < this->Balls.Size(); ++ball)
+    {
+        // broad phase: the cells around the ball, with a radius of slack for relocations
+        glm::vec2 boxMin = this->Balls.Positions[ball] - radius;
+        glm::vec2 boxMax = this->Balls.Positions[ball] + glm::vec2(radius * 2.0f) + radius;
+        // narrow phase: live bricks are tested BATCH_WIDTH at a time, in grid order
+        BrickBatch batch;
+        level.ForEachBrickIn(boxMin, boxMax, [&](unsigned int index) {
+            if (bricks.IsDestroyed(index))
+                return;
+            batch.Add(index, bricks.Positions[index], bricks.Sizes[index]);
+            if (batch.Count == BATCH_WIDTH)
+            {
+                this->collideBatch(ball, batch);
+                batch.Count = 0;
+            }
+        });
+        if (batch.Count > 0)
+            this->collideBatch(ball, batch);
+    }
+    this->catchPowerUps();
+    for (unsigned int ball = 0; ball < this->Balls.Size(); ++ball)
+    {
+        Collision result = CheckCollision(this->Balls.Positions[ball] + radius, radius, this->Player.Position, this->Player.Size);
+        if (!this->Balls.Stuck.Test(ball) && std::get<0>(result))
+            this->hitPaddle(ball, PLAYER_ONE);
+        if (this->Versus && !this->Balls.Stuck.Test(ball)
+            && std::get<0>(CheckCollision(this->Balls.Positions[ball] + radius, radius, this->Opponent.Position, this->Opponent.Size)))
+            this->hitPaddle(ball, PLAYER_TWO);
+    }
+}
+
+// what the ball touched first during a sweep
+enum SweepTarget {
+    SWEEP_NONE,
+    SWEEP_WALL,
+    SWEEP_BRICK,
+    SWEEP_PADDLE
+};
+
+void Simulation::SweepBalls(float dt)
+{
+    this->StepEvents = 0;
+    for (unsigned int ball = 0; ball < this->Balls.Size(); ++ball)
+        this->StepEvents = std::max(this->StepEvents, this->sweepBall(ball, dt));
+}
+
+unsigned int Simulation::sweepBall(unsigned int ball, float dt)
+{
+    if (this->Balls.Stuck.Test(ball))
+        return 0;
+    glm::vec2& position = this->Balls.Positions[ball];
+    glm::vec2& velocity = this->Balls.Velocities[ball];
+    float radius = this->Balls.Radius;
+    GameLevel& level = this->Levels[this->Level];
+    BrickStore& bricks = level.Bricks;
+    unsigned int events = 0;
+    float remaining = 1.0f; // fraction of dt still to simulate
+    while (remaining > 0.0f && events < MAX_SWEEP_EVENTS)
+    {
+        glm::vec2 center = position + radius;
+        glm::vec2 motion = velocity * dt * remaining;
+        SweepHit first;
+        SweepTarget target = SWEEP_NONE;
+        unsigned int brick = 0;
+        // walls: left, right and top; the bottom is open
+        float walls[3] = { 2.0f, 2.0f, 2.0f };
+        glm::vec2 wallNormals[3] = { glm::vec2(1.0f, 0.0f), glm::vec2(-1.0f, 0.0f), glm::vec2(0.0f, 1.0f) };
+        if (motion.x < 0.0f)
+            walls[0] = (radius - center.x) / motion.x;
+        else if (motion.x > 0.0f)
+            walls[1] = (this->Width - radius - center.x) / motion.x;
+        if (motion.y < 0.0f && !this->Versus) // the top is open in versus
+            walls[2] = (radius - center.y) / motion.y;
+        for (int i = 0; i < 3; ++i)
+        {
+            float t = std::max(walls[i], 0.0f); // negative: already past the wall
+            if (t < first.Time)
+            {
+                first.Hit = true;
+                first.Time = t;
+                first.Normal = wallNormals[i];
+                target = SWEEP_WALL;
+            }
+        }
+        // broad phase: the grid cells covered by the swept circle
+        glm::vec2 sweepMin = glm::min(center, center + motion) - radius;
+        glm::vec2 sweepMax = glm::max(center, center + motion) + radius;
+        // narrow phase: every brick there the ball can still interact with
+        level.ForEachBrickIn(sweepMin, sweepMax, [&](unsigned int index) {
+            if (bricks.IsDestroyed(index) || (this->Balls.Ghost && bricks.IsSolid(index)))
+                return;
+            SweepHit hit = SweepCircleAABB(center, radius, motion, bricks.Positions[index], bricks.Positions[index] + bricks.Sizes[index]);
+            if (hit.Hit && hit.Time < first.Time)
+            {
+                first = hit;
+                target = SWEEP_BRICK;
+                brick = index;
+            }
+        });
+        unsigned int player = PLAYER_ONE;
+        for (unsigned int p = PLAYER_ONE; p <= (this->Versus ? PLAYER_TWO : PLAYER_ONE); ++p)
+        {
+            const GameObject& board = this->Paddle(p);
+            SweepHit paddle = SweepCircleAABB(center, radius, motion, board.Position, board.Position + board.Size);
+            if (paddle.Hit && paddle.Time < first.Time)
+            {
+                first = paddle;
+                target = SWEEP_PADDLE;
+                player = p;
+            }
+        }
+        if (target == SWEEP_NONE)
+        {
+            position += motion;
+            break;
+        }
+        // advance to the contact and resolve it
+        position += motion * first.Time;
+        remaining *= 1.0f - first.Time;
+        ++events;
+        bool bounce = true;
+        if (target == SWEEP_BRICK)
+            bounce = this->hitBrick(ball, brick);
+        if (target == SWEEP_PADDLE)
+            this->hitPaddle(ball, player);
+        else if (bounce)
+        {   // reflect along the dominant axis of the contact normal, like the discrete resolution does
+            int axis = std::abs(first.Normal.x) > std::abs(first.Normal.y) ? 0 : 1;
+            velocity[axis] = first.Normal[axis] > 0.0f ? std::abs(velocity[axis]) : -std::abs(velocity[axis]);
+            // a corner can leave the ball still moving into the contact; reflect the other axis as well then
+            if (glm::dot(velocity, first.Normal) < 0.0f)
+                velocity[1 - axis] = first.Normal[1 - axis] > 0.0f ? std::abs(velocity[1 - axis]) : -std::abs(velocity[1 - axis]);
+        }
+        if (this->Balls.Stuck.Test(ball))
+            break;
+    }
+    return events;
+}
@@ -0,0 +1,239 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "game_object.h"
+#include "ball_pool.h"
+#include "game_level.h"
+#include "level_catalog.h"
+#include "powerup.h"
+#include "effect_timers.h"
+#include "alias_table.h"
+#include "pcg32.h"
+#include "event_queue.h"
+
+struct BrickBatch;
+
+// Initial size of the player paddle
+const glm::vec2 PLAYER_SIZE(100.0f, 20.0f);
+// Initial velocity of the player paddle
+const float PLAYER_VELOCITY(500.0f);
+// Initial velocity of the ball
+const glm::vec2 INITIAL_BALL_VELOCITY(100.0f, -350.0f);
+// Bytes of brick data the levels of a catalog may keep loaded, besides the one being played
+const size_t LEVEL_MEMORY_BUDGET = 64 << 20;
+// Radius of the ball object
+const float BALL_RADIUS = 12.5f;
+// Angle in radians the balls of a multi-ball serve fan out over
+const float SERVE_SPREAD = 1.0f;
+// Angle in radians between a ball and the copies the multi-ball powerup splits off it
+const float MULTI_BALL_SPREAD = 0.3f;
+
+// Players of a versus game; outside versus PLAYER_ONE is the only one
+const unsigned int PLAYER_ONE = 0;
+const unsigned int PLAYER_TWO = 1;
+// Winner of a versus game that ended in a draw
+const unsigned int NO_WINNER = 2;
+
+// Maximum number of contacts resolved for one ball within one swept step
+const unsigned int MAX_SWEEP_EVENTS = 16;
+
+// How the ball is moved and collided every step
+enum CollisionMode {
+	COLLISION_DISCRETE, // move, then push the ball out of whatever it overlaps
+	COLLISION_SWEPT     // sweep the ball and resolve contacts in time-of-impact order
+};
+
+enum GameState {
+	GAME_ACTIVE,
+	GAME_MENU,
+	GAME_WIN
+};
+
+// The player's controls for a single simulation step.
+struct SimInput {
+    bool Left;
+    bool Right;
+    bool Launch;
+
+    SimInput() : Left(false), Right(false), Launch(false) { }
+};
+
+// The keys the game reacts to, one bit each; a client maps its physical
+// keys onto these and hands the mask of held keys to ProcessKeys every tick.
+enum GameKey {
+    GAME_KEY_LEFT       = 1 << 0,
+    GAME_KEY_RIGHT      = 1 << 1,
+    GAME_KEY_LAUNCH     = 1 << 2,
+    GAME_KEY_CONFIRM    = 1 << 3,   // start a game, leave the win screen
+    GAME_KEY_NEXT_LEVEL = 1 << 4,   // level selection in the menu
+    GAME_KEY_PREV_LEVEL = 1 << 5
+};
+
+// the paddle controls among a mask of held GameKey bits
+inline SimInput PaddleInput(unsigned int keys)
+{
+    SimInput input;
+    input.Left = (keys & GAME_KEY_LEFT) != 0;
+    input.Right = (keys & GAME_KEY_RIGHT) != 0;
+    input.Launch = (keys & GAME_KEY_LAUNCH) != 0;
+    return input;
+}
+
+// Simulation owns the complete gameplay state of one Breakout game:
+// the paddle, the balls, the levels with their bricks and all powerups.
+// It only depends on glm and the standard library so it can be stepped
+// without a window, GPU or audio device; any number of instances can
+// live side by side. Game is a client that feeds input into it and
+// renders its state.
+class Simulation
+{
+public:
+    // game state
+    GameState               State;
+    unsigned int            Width, Height;
+    std::vector<GameLevel>  Levels;
+    std::vector<std::string> LevelFiles;    // file each level was loaded from, empty for levels that weren't
+    // the catalog the first levels come from; they are loaded when first
+    // needed and the least recently used go again past LevelBudget bytes
+    std::shared_ptr<LevelCatalog> Catalog;
+    size_t                  LevelBudget;
+    unsigned int            Level;
+    unsigned int            Lives;
+    GameObject              Player;
+    BallPool                Balls;
+    unsigned int            ServeBalls;     // balls put on the paddle at every serve
+    std::vector<PowerUp>    PowerUps;       // falling powerups
+    EffectTimers            Effects;        // caught powerups whose effect is running
+    Pcg32                   Random;         // gameplay stream; nothing else may draw from it
+    float                   DropChances[POWERUP_TYPES]; // percentage of destroyed bricks that drop each type
+    AliasTable              Drops;          // what a destroyed brick drops: a PowerUpType, or POWERUP_TYPES for nothing
+    // collision state
+    CollisionMode           Collisions;
+    unsigned int            StepEvents;     // most contacts resolved for one ball during the last swept step
+    // effect state, read by the client to drive post processing and music
+    bool                    Shake, Confuse, Chaos, SlowMo;
+    float                   ShakeTime;
+    // versus state: PLAYER_TWO plays Opponent, a paddle at the top of the screen
+    bool                    Versus;
+    GameObject              Opponent;
+    unsigned int            OpponentLives;
+    unsigned int            Scores[2];      // breakable bricks destroyed by each player's balls
+    unsigned int            Serving;        // player whose paddle the next serve starts from
+    unsigned int            Winner;         // player who won the finished versus game, or NO_WINNER
+    // menu keys that were handled and must be released before they count again
+    unsigned int            KeysProcessed;
+    // what happened since the client last drained it: sound, particle and statistics cues
+    EventQueue              Events;
+    // constructor
+    Simulation(unsigned int width, unsigned int height);
+    // catalogs the levels installed in the levels/ directory, the stock ones first, loads
+    // the first of them and the drop chances from powerups.cfg, and resets the player
+    void LoadLevels();
+    // makes the levels of the catalog the game's levels, none of them loaded yet
+    void UseCatalog(std::shared_ptr<LevelCatalog> catalog);
+    // makes level the current one, loading it if need be
+    void SelectLevel(unsigned int level);
+    // keeps the levels the catalog loaded ahead of time, e.g. the one highlighted in the menu; never waits
+    void AdoptLoadedLevels();
+    // patches the new tiles of a level file into every level loaded from it
+    // (see GameLevel::Patch) and returns the number of cells that changed
+    unsigned int ReloadLevel(const std::string& file, const std::vector<std::vector<unsigned int>>& tiles);
+    // adds a level streamed from source that scrolls down scrollSpeed pixels a second and returns its index;
+    // bricks that reach the paddle without being destroyed cost a life. The source needs at least one column
+    unsigned int AddStreamedLevel(std::shared_ptr<const ChunkSource> source, float scrollSpeed);
+    // restarts the gameplay random stream; games with the same seed and input play out the same
+    void Seed(uint64_t seed);
+    // advances the game by dt seconds using the given player input
+    void Step(float dt, SimInput input);
+    // handles the held GameKey bits for a tick: menu and win screen navigation, and the paddle while playing
+    void ProcessKeys(float dt, unsigned int keys);
+    // moves a player's paddle and launches the balls stuck to it
+    void ProcessInput(float dt, SimInput input, unsigned int player = PLAYER_ONE);
+    void Update(float dt);
+    void DoCollisions();
+    // starts a new game on the current level in place: full lives, the bricks
+    // back, no powerups falling or running, and a fresh serve
+    void Restart();
+    // starts a versus game on the given level: one paddle at the bottom,
+    // one at the top and the bricks in the middle band; needs swept collisions
+    void StartVersus(unsigned int level);
+    // advances a versus game by dt seconds using both players' input
+    void StepVersus(float dt, SimInput one, SimInput two);
+    // paddle of the given player
+    GameObject& Paddle(unsigned int player) { return player == PLAYER_TWO ? this->Opponent : this->Player; }
+    // moves every ball through the step, resolving each contact in time order
+    void SweepBalls(float dt);
+    // reset; ResetLevel brings back the current level's bricks and the lives
+    void ResetLevel();
+    void ResetPlayer();
+    // powerups
+    // sets the percentage of destroyed bricks that drop each PowerUpType; they may add up to at most 100
+    void SetDropChances(const float chances[POWERUP_TYPES]);
+    // reads drop chances from a file of "name percentage" lines, # starting a comment; powerups
+    // it leaves out keep their POWERUP_TABLE chance. Returns false and keeps the old chances if it
+    // can't be read, names an unknown powerup or the chances add up to more than 100
+    bool LoadDropChances(const char* file);
+    void SpawnPowerUps(glm::vec2 position);
+    void UpdatePowerUps(float dt);
+    // applies a powerup caught by the given player's paddle and starts its timer
+    void ActivatePowerUp(PowerUpType type, unsigned int player = PLAYER_ONE);
+    // splits two more balls off every ball in play
+    void SplitBalls();
+private:
+    // the activate and deactivate hooks of POWERUP_TABLE
+    friend struct PowerUpEffects;
+    // side effects of a ball touching a brick of the current level, returns whether the ball bounces off it
+    bool hitBrick(unsigned int ball, unsigned int index);
+    // collides a ball with a batch of bricks in lane order
+    void collideBatch(unsigned int ball, const BrickBatch& batch);
+    // sweeps one ball through the step and returns the number of contacts it resolved
+    unsigned int sweepBall(unsigned int ball, float dt);
+    // redirects a ball based on where it touched the player's paddle
+    void hitPaddle(unsigned int ball, unsigned int player);
+    // moves the balls stuck to the player's paddle along with it
+    void moveStuckBalls(unsigned int player, float dx);
+    // takes a life from the player; ends the game or serves again
+    void loseLife(unsigned int player);
+    // top left corner of the area the current mode lays levels out in
+    glm::vec2 levelOrigin() const;
+    // activates powerups that touch the paddle
+    void catchPowerUps();
+    // applies the gameplay consequences of the tick's events: scores, powerup drops and screen shake
+    void applyEvents();
+    // what the tick did that changes the game, in the order it happened; unlike
+    // the event queue these are never overwritten, however many bricks break
+    struct BrickBreak {
+        glm::vec2     Position;
+        unsigned char Player;
+    };
+    std::vector<BrickBreak> tickBreaks;
+    bool                    tickSolidHit;
+    // level use: when each catalog level was last needed, 0 while it isn't loaded
+    std::vector<uint64_t>   levelUses;
+    uint64_t                useClock;
+    // loads a catalog level unless it is loaded and marks it used
+    void loadLevel(unsigned int level);
+    // unloads the least recently used catalog levels other than the current one until they fit LevelBudget
+    void evictLevels();
+};
+
+// What a PowerUpType looks like, how often it drops and what it does.
+// Effects with a duration are reverted by Deactivate once the last
+// running effect of the type runs out; instant effects have none.
+struct PowerUpDescriptor {
+    const char*  Name;          // for statistics and logs
+    const char*  Texture;       // name of the texture the client draws it with
+    glm::vec3    Color;
+    float        Duration;      // seconds the effect lasts
+    float        DropChance;    // percentage of destroyed bricks that drop it, unless powerups.cfg says otherwise
+    void (*Activate)(Simulation& sim, unsigned int player);
+    void (*Deactivate)(Simulation& sim);
+};
+extern const PowerUpDescriptor POWERUP_TABLE[POWERUP_TYPES];
+
+#endif
@@ -0,0 +1,136 @@
+#include "snapshot.h"
+
+#include <cstring>
+
+bool SimSnapshot::Save(const Simulation& sim)
+{
+    const BrickStore& bricks = sim.Levels[sim.Level].Bricks;
+    if (sim.Levels[sim.Level].IsStreamed() || bricks.Size() > SNAPSHOT_MAX_BRICKS || sim.PowerUps.size() > SNAPSHOT_MAX_POWERUPS
+        || sim.Effects.Size() > SNAPSHOT_MAX_EFFECTS)
+        return false;
+    this->State = sim.State;
+    this->Level = sim.Level;
+    this->Lives = sim.Lives;
+    this->ServeBalls = sim.ServeBalls;
+    this->Collisions = sim.Collisions;
+    this->StepEvents = sim.StepEvents;
+    this->KeysProcessed = sim.KeysProcessed;
+    this->Random = sim.Random;
+    this->Shake = sim.Shake;
+    this->Confuse = sim.Confuse;
+    this->Chaos = sim.Chaos;
+    this->SlowMo = sim.SlowMo;
+    this->ShakeTime = sim.ShakeTime;
+    this->Player = sim.Player;
+    this->Versus = sim.Versus;
+    this->Opponent = sim.Opponent;
+    this->OpponentLives = sim.OpponentLives;
+    this->Serving = sim.Serving;
+    this->Winner = sim.Winner;
+    this->Scores[0] = sim.Scores[0];
+    this->Scores[1] = sim.Scores[1];
+    // balls
+    const BallPool& balls = sim.Balls;
+    this->BallCount = balls.Size();
+    this->BallRadius = balls.Radius;
+    this->BallColor = balls.Color;
+    this->Sticky = balls.Sticky;
+    this->PassThrough = balls.PassThrough;
+    this->Ghost = balls.Ghost;
+    std::memcpy(this->BallPositions, balls.Positions.data(), this->BallCount * sizeof(glm::vec2));
+    std::memcpy(this->BallVelocities, balls.Velocities.data(), this->BallCount * sizeof(glm::vec2));
+    std::memcpy(this->BallOldVelocities, balls.OldVelocities.data(), this->BallCount * sizeof(glm::vec2));
+    std::memcpy(this->BallStuck, balls.Stuck.Words.data(), balls.Stuck.Words.size() * sizeof(uint64_t));
+    std::memcpy(this->BallOwners, balls.Owners.data(), this->BallCount);
+    // bricks
+    this->BrickCount = bricks.Size();
+    this->LevelOrigin = sim.Levels[sim.Level].Origin;
+    this->Progress = bricks.Progress;
+    std::memcpy(this->BricksDestroyed, bricks.Destroyed.Words.data(), bricks.Destroyed.Words.size() * sizeof(uint64_t));
+    // powerups
+    this->PowerUpCount = static_cast<unsigned int>(sim.PowerUps.size());
+    for (unsigned int i = 0; i < this->PowerUpCount; ++i)
+    {
+        const PowerUp& powerUp = sim.PowerUps[i];
+        SnapshotPowerUp& saved = this->PowerUps[i];
+        saved.Object = powerUp;
+        saved.Kind = powerUp.Type;
+    }
+    // effects
+    const EffectTimers& effects = sim.Effects;
+    this->EffectClock = effects.Clock;
+    std::memcpy(this->EffectsActive, effects.Active, sizeof(effects.Active));
+    this->EffectCount = effects.Size();
+    std::memcpy(this->Effects, effects.Heap.data(), this->EffectCount * sizeof(EffectTimer));
+    return true;
+}
+
+bool SimSnapshot::Restore(Simulation& sim) const
+{
+    if (this->Level >= sim.Levels.size() || sim.Levels[this->Level].Bricks.Size() != this->BrickCount)
+        return false;
+    sim.State = this->State;
+    sim.Level = this->Level;
+    sim.Lives = this->Lives;
+    sim.ServeBalls = this->ServeBalls;
+    sim.Collisions = this->Collisions;
+    sim.StepEvents = this->StepEvents;
+    sim.KeysProcessed = this->KeysProcessed;
+    sim.Random = this->Random;
+    sim.Shake = this->Shake;
+    sim.Confuse = this->Confuse;
+    sim.Chaos = this->Chaos;
+    sim.SlowMo = this->SlowMo;
+    sim.ShakeTime = this->ShakeTime;
+    sim.Player = this->Player;
+    sim.Versus = this->Versus;
+    sim.Opponent = this->Opponent;
+    sim.OpponentLives = this->OpponentLives;
+    sim.Serving = this->Serving;
+    sim.Winner = this->Winner;
+    sim.Scores[0] = this->Scores[0];
+    sim.Scores[1] = this->Scores[1];
+    // balls; the pool keeps its capacity, so this doesn't allocate after the first restore
+    BallPool& balls = sim.Balls;
+    balls.Radius = this->BallRadius;
+    balls.Color = this->BallColor;
+    balls.Sticky = this->Sticky;
+    balls.PassThrough = this->PassThrough;
+    balls.Ghost = this->Ghost;
+    balls.Positions.resize(this->BallCount);
+    balls.Velocities.resize(this->BallCount);
+    balls.OldVelocities.resize(this->BallCount);
+    balls.Owners.resize(this->BallCount);
+    balls.Stuck.Assign(this->BallCount);
+    std::memcpy(balls.Positions.data(), this->BallPositions, this->BallCount * sizeof(glm::vec2));
+    std::memcpy(balls.Velocities.data(), this->BallVelocities, this->BallCount * sizeof(glm::vec2));
+    std::memcpy(balls.OldVelocities.data(), this->BallOldVelocities, this->BallCount * sizeof(glm::vec2));
+    std::memcpy(balls.Stuck.Words.data(), this->BallStuck, balls.Stuck.Words.size() * sizeof(uint64_t));
+    std::memcpy(balls.Owners.data(), this->BallOwners, this->BallCount);
+    // bricks
+    // a level moved since, e.g. into or out of the versus band, is laid out again first
+    GameLevel& level = sim.Levels[this->Level];
+    if (level.Origin != this->LevelOrigin)
+        level.Reset(this->LevelOrigin);
+    BrickStore& bricks = level.Bricks;
+    bricks.Progress = this->Progress;
+    std::memcpy(bricks.Destroyed.Words.data(), this->BricksDestroyed, bricks.Destroyed.Words.size() * sizeof(uint64_t));
+    // powerups; existing ones are overwritten in place
+    if (sim.PowerUps.size() > this->PowerUpCount)
+        sim.PowerUps.erase(sim.PowerUps.begin() + this->PowerUpCount, sim.PowerUps.end());
+    for (unsigned int i = 0; i < this->PowerUpCount; ++i)
+    {
+        const SnapshotPowerUp& saved = this->PowerUps[i];
+        if (i == sim.PowerUps.size())
+            sim.PowerUps.push_back(PowerUp(static_cast<PowerUpType>(saved.Kind), saved.Object.Color, saved.Object.Position));
+        PowerUp& powerUp = sim.PowerUps[i];
+        static_cast<GameObject&>(powerUp) = saved.Object;
+        powerUp.Type = static_cast<PowerUpType>(saved.Kind);
+    }
+    // effects; the heap layout is restored as it was, so timers that run out together do so in the same order
+    EffectTimers& effects = sim.Effects;
+    effects.Clock = this->EffectClock;
+    std::memcpy(effects.Active, this->EffectsActive, sizeof(effects.Active));
+    effects.Heap.assign(this->Effects, this->Effects + this->EffectCount);
+    return true;
+}
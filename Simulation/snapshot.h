@@ -0,0 +1,81 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include "simulation.h"
+
+// Largest level whose brick state fits in a snapshot
+const unsigned int SNAPSHOT_MAX_BRICKS = 4096;
+// Most falling powerups a snapshot holds
+const unsigned int SNAPSHOT_MAX_POWERUPS = 256;
+// Most running powerup effects a snapshot holds
+const unsigned int SNAPSHOT_MAX_EFFECTS = 256;
+
+// A powerup as stored in a snapshot: its type is its PowerUpType
+struct SnapshotPowerUp {
+    GameObject    Object;
+    unsigned char Kind;
+};
+
+// SimSnapshot is the complete changing state of a Simulation in one flat,
+// trivially copyable block: the balls, the paddles, the destroyed bricks and
+// origin of the current level, all powerups and effect timers, the effect flags,
+// lives, level and the random stream. Saving and restoring copy a few arrays with memcpy, so
+// save states, rewind buffers and branching many games off a common prefix
+// cost microseconds instead of a replay from the start. Snapshots can be
+// copied and stored like any plain struct.
+//
+// Only the current level's bricks are saved; the other levels are never
+// touched while not being played. Streamed levels page their rows in
+// and out as they scroll, so they can't be saved. A snapshot restores into the simulation
+// it was taken from, or one set up with the same levels and screen size.
+// The event queue is not part of it and is left alone on restore; callers
+// decide which of the queued events still matter.
+struct SimSnapshot {
+    // game state
+    GameState     State;
+    unsigned int  Level, Lives, ServeBalls;
+    CollisionMode Collisions;
+    unsigned int  StepEvents, KeysProcessed;
+    Pcg32         Random;
+    bool          Shake, Confuse, Chaos, SlowMo;
+    float         ShakeTime;
+    GameObject    Player;
+    // versus
+    bool          Versus;
+    GameObject    Opponent;
+    unsigned int  OpponentLives, Serving, Winner;
+    unsigned int  Scores[2];
+    // balls
+    unsigned int  BallCount;
+    float         BallRadius;
+    glm::vec3     BallColor;
+    bool          Sticky, PassThrough, Ghost;
+    glm::vec2     BallPositions[MAX_BALLS];
+    glm::vec2     BallVelocities[MAX_BALLS];
+    glm::vec2     BallOldVelocities[MAX_BALLS];
+    uint64_t      BallStuck[MAX_BALLS / 64];
+    unsigned char BallOwners[MAX_BALLS];
+    // bricks of the current level, and where it is laid out
+    unsigned int  BrickCount;
+    glm::vec2     LevelOrigin;
+    BrickProgress Progress;
+    uint64_t      BricksDestroyed[SNAPSHOT_MAX_BRICKS / 64];
+    // powerups
+    unsigned int    PowerUpCount;
+    SnapshotPowerUp PowerUps[SNAPSHOT_MAX_POWERUPS];
+    // effect timers, the heap in its own order
+    double          EffectClock;
+    unsigned int    EffectsActive[POWERUP_TYPES];
+    unsigned int    EffectCount;
+    EffectTimer     Effects[SNAPSHOT_MAX_EFFECTS];
+
+    // copies the state of sim; returns false if its level is streamed or its level, powerups or effects don't fit
+    bool Save(const Simulation& sim);
+    // puts sim back into the saved state; returns false if sim has a different level layout
+    bool Restore(Simulation& sim) const;
+};
+
+#endif
@@ -0,0 +1,152 @@
+#include "udp_link.h"
+
+#include <cstring>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+typedef int socklen_t;
+typedef SOCKET NativeSocket;
+const NativeSocket NO_SOCKET = INVALID_SOCKET;
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+typedef int NativeSocket;
+const NativeSocket NO_SOCKET = -1;
+#endif
+
+// Stream of the link's random generator, apart from the game's streams
+const uint64_t RNG_STREAM_LINK = 3;
+
+UdpLink::UdpLink()
+    : socket(-1), peer(), random(0, RNG_STREAM_LINK)
+{
+#ifdef _WIN32
+    WSADATA data;
+    WSAStartup(MAKEWORD(2, 2), &data);
+#endif
+}
+
+UdpLink::~UdpLink()
+{
+    this->Close();
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+bool UdpLink::Open(unsigned short localPort, const char* peerHost, unsigned short peerPort, uint64_t seed)
+{
+    this->Close();
+    this->random.Seed(seed, RNG_STREAM_LINK);
+    sockaddr_in local;
+    std::memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    local.sin_port = htons(localPort);
+    sockaddr_in remote;
+    std::memset(&remote, 0, sizeof(remote));
+    remote.sin_family = AF_INET;
+    remote.sin_port = htons(peerPort);
+    if (inet_pton(AF_INET, peerHost, &remote.sin_addr) != 1)
+        return false;
+    static_assert(sizeof(remote) <= sizeof(UdpLink::peer), "peer address does not fit");
+    std::memcpy(this->peer, &remote, sizeof(remote));
+
+    NativeSocket native = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (native == NO_SOCKET)
+        return false;
+    this->socket = static_cast<intptr_t>(native);
+#ifdef _WIN32
+    u_long nonBlocking = 1;
+    bool ready = ioctlsocket(native, FIONBIO, &nonBlocking) == 0;
+#else
+    bool ready = fcntl(native, F_SETFL, O_NONBLOCK) == 0;
+#endif
+    if (!ready || bind(native, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0)
+    {
+        this->Close();
+        return false;
+    }
+    return true;
+}
+
+void UdpLink::Close()
+{
+    if (this->socket == -1)
+        return;
+#ifdef _WIN32
+    closesocket(static_cast<NativeSocket>(this->socket));
+#else
+    close(static_cast<NativeSocket>(this->socket));
+#endif
+    this->socket = -1;
+    this->delayed.clear();
+}
+
+void UdpLink::Send(const unsigned char* data, size_t size)
+{
+    if (this->Conditions.Loss > 0.0f && this->random.NextDouble() < this->Conditions.Loss)
+        return;
+    float delayMs = this->Conditions.LatencyMs + this->Conditions.JitterMs * static_cast<float>(this->random.NextDouble());
+    if (delayMs <= 0.0f)
+        this->sendNow(data, size);
+    else
+    {
+        Delayed packet;
+        packet.Due = std::chrono::steady_clock::now() + std::chrono::microseconds(static_cast<long long>(delayMs * 1000.0f));
+        packet.Data.assign(data, data + size);
+        this->delayed.push_back(packet);
+    }
+    this->flush();
+}
+
+size_t UdpLink::Receive(unsigned char* buffer, size_t capacity)
+{
+    this->flush();
+    if (this->socket == -1)
+        return 0;
+    const sockaddr_in& peer = *reinterpret_cast<const sockaddr_in*>(this->peer);
+    for (;;)
+    {
+        sockaddr_in from;
+        socklen_t length = sizeof(from);
+        long received = recvfrom(static_cast<NativeSocket>(this->socket), reinterpret_cast<char*>(buffer), static_cast<int>(capacity), 0,
+                                 reinterpret_cast<sockaddr*>(&from), &length);
+        // errors (would block, or the peer's port not open yet) mean nothing arrived
+        if (received <= 0)
+            return 0;
+        // only the peer's packets count
+        if (from.sin_port == peer.sin_port && from.sin_addr.s_addr == peer.sin_addr.s_addr)
+            return static_cast<size_t>(received);
+    }
+}
+
+void UdpLink::flush()
+{
+    auto now = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < this->delayed.size(); )
+    {
+        if (this->delayed[i].Due <= now)
+        {
+            this->sendNow(this->delayed[i].Data.data(), this->delayed[i].Data.size());
+            if (i + 1 < this->delayed.size())
+                this->delayed[i] = std::move(this->delayed.back());
+            this->delayed.pop_back();
+        }
+        else
+            ++i;
+    }
+}
+
+void UdpLink::sendNow(const unsigned char* data, size_t size)
+{
+    if (this->socket == -1)
+        return;
+    sendto(static_cast<NativeSocket>(this->socket), reinterpret_cast<const char*>(data), static_cast<int>(size), 0,
+           reinterpret_cast<const sockaddr*>(this->peer), sizeof(sockaddr_in));
+}
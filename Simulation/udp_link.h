@@ -0,0 +1,53 @@
+#ifndef UDP_LINK_H
+#define UDP_LINK_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "pcg32.h"
+
+// Network trouble a UdpLink fakes on the packets it sends, so rollback
+// can be exercised between two processes on one machine.
+struct LinkConditions {
+    float LatencyMs;    // added to every packet
+    float JitterMs;     // up to this much more, so packets also arrive out of order
+    float Loss;         // fraction of packets dropped, 0..1
+
+    LinkConditions() : LatencyMs(0.0f), JitterMs(0.0f), Loss(0.0f) { }
+};
+
+// UdpLink is a non-blocking UDP socket talking to a single peer. Packets
+// go out unreliably and unordered, just like plain UDP; with Conditions
+// set they are held back or dropped before being sent. The link only
+// moves bytes, the RollbackSession decides what is in them.
+class UdpLink
+{
+public:
+    LinkConditions Conditions;
+    // constructor/destructor
+    UdpLink();
+    ~UdpLink();
+    // binds localPort and sends to peerHost:peerPort (a dotted IPv4 address); returns false on failure
+    bool Open(unsigned short localPort, const char* peerHost, unsigned short peerPort, uint64_t seed = 0);
+    void Close();
+    // queues a packet for the peer; delayed packets go out on later Send or Receive calls
+    void Send(const unsigned char* data, size_t size);
+    // copies the next packet from the peer into buffer and returns its size, or 0 when there is none
+    size_t Receive(unsigned char* buffer, size_t capacity);
+private:
+    struct Delayed {
+        std::chrono::steady_clock::time_point Due;
+        std::vector<unsigned char>            Data;
+    };
+    intptr_t             socket;        // SOCKET on Windows, a file descriptor elsewhere; -1 when closed
+    unsigned char        peer[16];      // sockaddr_in of the peer
+    std::vector<Delayed> delayed;
+    Pcg32                random;        // decides which packets are dropped and how late they are
+    // sends the delayed packets that are due
+    void flush();
+    void sendNow(const unsigned char* data, size_t size);
+};
+
+#endif
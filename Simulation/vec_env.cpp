@@ -0,0 +1,143 @@
+#include "vec_env.h"
+
+#include <algorithm>
+
+// Fewest instances stepped by one pool task, so small batches don't drown in task overhead
+const unsigned int STEP_CHUNK = 64;
+
+VecEnv::VecEnv(unsigned int count, unsigned int level, unsigned int threads)
+    : Count(count), Level(level), TickLength(1.0f / 120.0f), TicksPerStep(1), MaxTicks(120 * 60 * 5),
+      Rewards(count, 0.0f), Dones(count, 0), Ticks(count, 0), Episodes(count, 0),
+      prototype(800, 600), seed(0), pool(threads)
+{
+    this->prototype.LoadLevels();
+    if (level < this->prototype.Levels.size())
+        this->prototype.SelectLevel(level);
+    if (this->Ready())
+        this->prototype.ResetPlayer();
+    // nobody listens to the instances' events
+    this->prototype.Events.Mute(true);
+    this->games.assign(count, this->prototype);
+}
+
+void VecEnv::Reset(uint64_t seed)
+{
+    this->seed = seed;
+    for (unsigned int i = 0; i < this->Count; ++i)
+    {
+        this->Episodes[i] = 0;
+        this->Rewards[i] = 0.0f;
+        this->Dones[i] = 0;
+        this->restart(i);
+    }
+}
+
+void VecEnv::restart(unsigned int i)
+{
+    // in place: the instance keeps its level and storage, only the game state starts over
+    this->games[i].Restart();
+    this->games[i].Seed(this->seed + i + static_cast<uint64_t>(this->Episodes[i]) * this->Count);
+    this->Ticks[i] = 0;
+}
+
+void VecEnv::Step(const unsigned char* actions)
+{
+    unsigned int chunk = std::max(STEP_CHUNK, this->Count / (this->pool.Size() * 4) + 1);
+    if (this->pool.Size() == 1 || this->Count <= chunk)
+    {
+        this->stepRange(0, this->Count, actions);
+        return;
+    }
+    for (unsigned int begin = 0; begin < this->Count; begin += chunk)
+    {
+        unsigned int end = std::min(begin + chunk, this->Count);
+        this->pool.Submit([this, begin, end, actions](unsigned int) { this->stepRange(begin, end, actions); });
+    }
+    this->pool.Wait();
+}
+
+void VecEnv::stepRange(unsigned int begin, unsigned int end, const unsigned char* actions)
+{
+    for (unsigned int i = begin; i < end; ++i)
+    {
+        Simulation& sim = this->games[i];
+        SimInput input = PaddleInput(actions[i]);
+        float reward = 0.0f;
+        bool done = false;
+        for (unsigned int tick = 0; tick < this->TicksPerStep && !done; ++tick)
+        {
+            float bricks = static_cast<float>(sim.Levels[sim.Level].Progress().Remaining);
+            float lives = static_cast<float>(sim.Lives);
+            sim.ProcessInput(this->TickLength, input);
+            sim.Update(this->TickLength);
+            ++this->Ticks[i];
+            // winning and losing reset the level and lives, the last brick and life were counted before
+            if (sim.State == GAME_ACTIVE)
+                reward += (bricks - sim.Levels[sim.Level].Progress().Remaining) - (lives - sim.Lives);
+            else if (sim.State == GAME_MENU)
+                reward -= lives;
+            done = sim.State != GAME_ACTIVE || (this->MaxTicks > 0 && this->Ticks[i] >= this->MaxTicks);
+        }
+        this->Rewards[i] = reward;
+        this->Dones[i] = done;
+        if (done)
+        {
+            ++this->Episodes[i];
+            this->restart(i);
+        }
+    }
+}
+
+unsigned int VecEnv::BrickWords() const
+{
+    return (this->prototype.Levels[this->Level].Bricks.Size() + 63) / 64;
+}
+
+void VecEnv::Observe(float* features, uint64_t* bricks) const
+{
+    unsigned int words = this->BrickWords();
+    unsigned int count = this->prototype.Levels[this->Level].Bricks.Size();
+    uint64_t lastWord = count % 64 == 0 ? ~uint64_t(0) : (uint64_t(1) << (count % 64)) - 1;
+    float width = static_cast<float>(this->prototype.Width), height = static_cast<float>(this->prototype.Height);
+    float speed = glm::length(INITIAL_BALL_VELOCITY);
+    for (unsigned int i = 0; i < this->Count; ++i)
+    {
+        const Simulation& sim = this->games[i];
+        const BallPool& balls = sim.Balls;
+        float* out = features + static_cast<size_t>(i) * OBS_FEATURES;
+        out[OBS_PADDLE_X] = (sim.Player.Position.x + sim.Player.Size.x / 2.0f) / width;
+        out[OBS_PADDLE_WIDTH] = sim.Player.Size.x / width;
+        out[OBS_LIVES] = static_cast<float>(sim.Lives);
+        out[OBS_BALL_COUNT] = static_cast<float>(balls.Size());
+        for (unsigned int b = 0; b < OBS_BALLS; ++b)
+        {
+            float* ball = out + OBS_BALL_FIRST + 4 * b;
+            if (b < balls.Size())
+            {
+                ball[0] = (balls.Positions[b].x + balls.Radius) / width;
+                ball[1] = (balls.Positions[b].y + balls.Radius) / height;
+                ball[2] = balls.Velocities[b].x / speed;
+                ball[3] = balls.Velocities[b].y / speed;
+            }
+            else
+                ball[0] = ball[1] = ball[2] = ball[3] = 0.0f;
+        }
+        out[OBS_STICKY] = balls.Sticky;
+        out[OBS_PASS_THROUGH] = balls.PassThrough;
+        out[OBS_GHOST] = balls.Ghost;
+        out[OBS_CONFUSE] = sim.Confuse;
+        out[OBS_CHAOS] = sim.Chaos;
+        out[OBS_SLOWMO] = sim.SlowMo;
+        unsigned int falling = 0;
+        for (const PowerUp& powerUp : sim.PowerUps)
+            falling += !powerUp.Destroyed;
+        out[OBS_FALLING_POWERUPS] = static_cast<float>(falling);
+        // standing breakable bricks: neither destroyed nor solid
+        const BrickStore& store = sim.Levels[sim.Level].Bricks;
+        uint64_t* bits = bricks + static_cast<size_t>(i) * words;
+        for (unsigned int w = 0; w < words; ++w)
+            bits[w] = ~(store.Destroyed.Words[w] | store.Solid.Words[w]);
+        if (words > 0)
+            bits[words - 1] &= lastWord;
+    }
+}
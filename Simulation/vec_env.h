@@ -0,0 +1,87 @@
+#ifndef VEC_ENV_H
+#define VEC_ENV_H
+
+#include <cstdint>
+#include <vector>
+
+#include "simulation.h"
+#include "work_stealing_pool.h"
+
+// Balls described in an observation; further balls in play are left out
+const unsigned int OBS_BALLS = 4;
+
+// Features of one instance in an observation, in order. Positions are
+// divided by the screen size, velocities by the initial ball speed.
+enum ObservationFeature {
+    OBS_PADDLE_X,                               // paddle center
+    OBS_PADDLE_WIDTH,
+    OBS_LIVES,
+    OBS_BALL_COUNT,
+    OBS_BALL_FIRST,                             // x, y, vx, vy of each ball, centers; 0 for missing balls
+    OBS_STICKY = OBS_BALL_FIRST + 4 * OBS_BALLS, // active effects, 0 or 1
+    OBS_PASS_THROUGH,
+    OBS_GHOST,
+    OBS_CONFUSE,
+    OBS_CHAOS,
+    OBS_SLOWMO,
+    OBS_FALLING_POWERUPS,                       // powerups dropped and not caught yet
+    OBS_FEATURES
+};
+
+// VecEnv steps a batch of independent single player games in lockstep,
+// the interface reinforcement learning trainers expect: Reset seeds every
+// instance, Step takes one action per instance and Observe writes the
+// state of all of them into flat arrays.
+//
+// Each instance is a full Simulation, already struct-of-arrays inside, so
+// every game plays exactly like it does in the client; the state is not
+// laid out struct-of-arrays across instances, and one tick does not advance
+// many games in one SIMD loop. The batch keeps the per instance results
+// (rewards, done flags, tick counts) as arrays of their own and steps chunks
+// of instances on a WorkStealingPool. Instances have their event queues
+// muted. An instance that finishes is started over in place with a new seed
+// within the same Step, and Dones marks it for that one step.
+//
+// An action is a mask of GameKey paddle bits. The reward of a step is the
+// number of bricks destroyed minus the number of lives lost; a game is
+// done when it is cleared, lost or has run MaxTicks ticks.
+class VecEnv
+{
+public:
+    unsigned int Count;             // number of instances
+    unsigned int Level;             // level every instance plays
+    float        TickLength;        // seconds per tick
+    unsigned int TicksPerStep;      // ticks an action is held for
+    unsigned int MaxTicks;          // ticks after which a game is cut off, 0 for none
+    // results of the last step, one entry per instance
+    std::vector<float>         Rewards;
+    std::vector<unsigned char> Dones;
+    std::vector<unsigned int>  Ticks;       // ticks into the current game
+    std::vector<unsigned int>  Episodes;    // games finished so far
+    // constructor; loads the stock levels from the levels/ directory once for all instances
+    VecEnv(unsigned int count, unsigned int level = 0, unsigned int threads = 0);
+    // whether the levels loaded and the level exists
+    bool Ready() const { return this->Level < this->prototype.Levels.size() && this->prototype.Levels[this->Level].Bricks.Size() > 0; }
+    // starts every instance over; instance i gets seed + i, and seed + i + k * Count for its k-th next game
+    void Reset(uint64_t seed);
+    // holds actions[i] for TicksPerStep ticks in instance i and fills Rewards, Dones and Ticks
+    void Step(const unsigned char* actions);
+    // 64-bit words per instance in the brick bitmap
+    unsigned int BrickWords() const;
+    // writes Count x OBS_FEATURES floats into features and Count x BrickWords()
+    // words into bricks, where bit b is set while breakable brick b of the level stands
+    void Observe(float* features, uint64_t* bricks) const;
+    // instance i, e.g. for rendering it
+    const Simulation& Instance(unsigned int i) const { return this->games[i]; }
+private:
+    Simulation              prototype;  // a fresh game, copied into instances when they start
+    std::vector<Simulation> games;
+    uint64_t                seed;
+    WorkStealingPool        pool;
+    // starts instance i over with its next seed
+    void restart(unsigned int i);
+    // steps instances [begin, end)
+    void stepRange(unsigned int begin, unsigned int end, const unsigned char* actions);
+};
+
+#endif
@@ -0,0 +1,100 @@
+#include "work_stealing_pool.h"
+
+#include <algorithm>
+
+WorkStealingPool::WorkStealingPool(unsigned int threads)
+    : queued(0), pending(0), next(0), stopping(false)
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int i = 0; i < threads; ++i)
+        this->workers.push_back(std::unique_ptr<Worker>(new Worker()));
+    for (unsigned int i = 0; i < threads; ++i)
+        this->threads.push_back(std::thread(&WorkStealingPool::run, this, i));
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        this->stopping = true;
+    }
+    this->wake.notify_all();
+    for (std::thread& thread : this->threads)
+        thread.join();
+}
+
+void WorkStealingPool::Submit(Task task)
+{
+    ++this->pending;
+    Worker& worker = *this->workers[this->next];
+    this->next = (this->next + 1) % this->Size();
+    {   // counted first, so a task is never taken before it is counted
+        std::lock_guard<std::mutex> guard(this->lock);
+        ++this->queued;
+    }
+    {
+        std::lock_guard<std::mutex> guard(worker.Lock);
+        worker.Tasks.push_back(std::move(task));
+    }
+    this->wake.notify_one();
+}
+
+void WorkStealingPool::Wait()
+{
+    std::unique_lock<std::mutex> guard(this->lock);
+    this->idle.wait(guard, [this] { return this->pending == 0; });
+}
+
+bool WorkStealingPool::take(unsigned int worker, Task& task)
+{
+    // newest own task first: its data is most likely still in cache
+    {
+        Worker& own = *this->workers[worker];
+        std::lock_guard<std::mutex> guard(own.Lock);
+        if (!own.Tasks.empty())
+        {
+            task = std::move(own.Tasks.back());
+            own.Tasks.pop_back();
+            --this->queued;
+            return true;
+        }
+    }
+    // then the oldest task of the next worker that has one
+    for (unsigned int i = 1; i < this->Size(); ++i)
+    {
+        Worker& victim = *this->workers[(worker + i) % this->Size()];
+        std::lock_guard<std::mutex> guard(victim.Lock);
+        if (!victim.Tasks.empty())
+        {
+            task = std::move(victim.Tasks.front());
+            victim.Tasks.pop_front();
+            --this->queued;
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::run(unsigned int worker)
+{
+    Task task;
+    for (;;)
+    {
+        if (this->take(worker, task))
+        {
+            task(worker);
+            task = nullptr;
+            if (--this->pending == 0)
+            {
+                std::lock_guard<std::mutex> guard(this->lock);
+                this->idle.notify_all();
+            }
+            continue;
+        }
+        std::unique_lock<std::mutex> guard(this->lock);
+        this->wake.wait(guard, [this] { return this->queued > 0 || this->stopping; });
+        if (this->stopping && this->queued == 0)
+            return;
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// WorkStealingPool runs tasks on a fixed set of worker threads. Every
+// worker owns a deque: it takes its own tasks from the back and, once
+// that runs dry, steals from the front of the other workers' deques, so
+// uneven tasks (games that last seconds or minutes) still keep every
+// core busy. Tasks get the index of the worker running them, which lets
+// callers keep per-worker results and merge them after Wait.
+class WorkStealingPool
+{
+public:
+    typedef std::function<void(unsigned int worker)> Task;
+    // starts the given number of workers; 0 uses one per hardware thread
+    WorkStealingPool(unsigned int threads = 0);
+    ~WorkStealingPool();
+    // number of workers
+    unsigned int Size() const { return static_cast<unsigned int>(this->workers.size()); }
+    // queues a task on the deques round robin
+    void Submit(Task task);
+    // blocks until every submitted task has finished
+    void Wait();
+private:
+    struct Worker {
+        std::mutex       Lock;
+        std::deque<Task> Tasks;
+    };
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread>             threads;
+    std::mutex                           lock;       // guards sleeping and waking
+    std::condition_variable              wake, idle;
+    std::atomic<unsigned int>            queued;     // tasks in all deques
+    std::atomic<unsigned int>            pending;    // tasks submitted but not finished
+    unsigned int                         next;
+    bool                                 stopping;
+    // takes a task from the worker's own deque or steals one from another
+    bool take(unsigned int worker, Task& task);
+    void run(unsigned int worker);
+};
+
+#endif
@@ -0,0 +1,206 @@
+#include "tools.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "autopilot.h"
+#include "batch.h"
+#include "simulation.h"
+#include "work_stealing_pool.h"
+
+// picks how many half paddle widths off center the paddle hits the ball
+static float pickAim(std::mt19937& random)
+{
+    return std::uniform_real_distribution<float>(-0.7f, 0.7f)(random);
+}
+
+// x position the ball will have when it reaches height y, folding its path back at the side walls
+static float predictX(const Simulation& sim, unsigned int ball, float y)
+{
+    float span = sim.Width - sim.Balls.Radius * 2.0f;
+    glm::vec2 position = sim.Balls.Positions[ball], velocity = sim.Balls.Velocities[ball];
+    float x = position.x + velocity.x * (y - position.y) / velocity.y;
+    x = std::fmod(std::abs(x), 2.0f * span);
+    return x > span ? 2.0f * span - x : x;
+}
+
+// Paddle policy of the batch runner: launches right away and moves under
+// the falling ball that will reach the paddle first, hitting it aim half
+// paddle widths off center so that games don't repeat the same bounces.
+static SimInput autoPaddle(const Simulation& sim, float aim)
+{
+    SimInput input;
+    input.Launch = true;
+    float paddleY = sim.Player.Position.y - sim.Balls.Radius * 2.0f;
+    float target = sim.Width / 2.0f, soonest = 0.0f;
+    bool found = false;
+    for (unsigned int i = 0; i < sim.Balls.Size(); ++i)
+    {
+        glm::vec2 velocity = sim.Balls.Velocities[i];
+        if (sim.Balls.Stuck.Test(i) || velocity.y <= 0.0f)
+            continue;
+        float time = (paddleY - sim.Balls.Positions[i].y) / velocity.y;
+        if (!found || time < soonest)
+        {
+            found = true;
+            soonest = time;
+            target = predictX(sim, i, paddleY) + sim.Balls.Radius;
+        }
+    }
+    float center = sim.Player.Position.x + sim.Player.Size.x / 2.0f;
+    float offset = target - aim * sim.Player.Size.x / 2.0f - center;
+    float deadZone = PLAYER_VELOCITY / BATCH_TICK_RATE;
+    input.Left = offset < -deadZone;
+    input.Right = offset > deadZone;
+    return input;
+}
+
+void PlayGame(const GameLevel& level, unsigned int seed, unsigned int maxTicks, Controller* controller, LevelStats& stats)
+{
+    std::mt19937 random(seed);
+    float aim = pickAim(random);
+    std::chrono::steady_clock::duration policy(0);
+    Simulation sim(800, 600);
+    sim.Seed(seed);
+    sim.Levels.push_back(level);
+    unsigned int tick = 0, bricksLeft = 0;
+    for (; tick < maxTicks && sim.State == GAME_ACTIVE; ++tick)
+    {
+        unsigned int lives = sim.Lives;
+        bricksLeft = sim.Levels[0].Progress().Remaining; // winning or losing resets the level
+        SimInput input;
+        if (controller)
+        {   // only timed here; autoPaddle is cheaper than reading the clock
+            auto decide = std::chrono::steady_clock::now();
+            input = PaddleInput(controller->Keys(sim, PLAYER_ONE, 1.0f / BATCH_TICK_RATE));
+            policy += std::chrono::steady_clock::now() - decide;
+        }
+        else
+            input = autoPaddle(sim, aim);
+        sim.Step(1.0f / BATCH_TICK_RATE, input);
+        // count the powerups caught and re-aim after every bounce off the paddle
+        sim.Events.Drain([&](const SimEvent& event) {
+            if (event.Type == EVENT_PADDLE_HIT)
+                for (unsigned int i = 0; i < event.Count; ++i)
+                    aim = pickAim(random);
+            else if (event.Type == EVENT_POWERUP_COLLECTED)
+                stats.PowerUps[POWERUP_TABLE[event.Kind].Name] += event.Count;
+        });
+        if (sim.State == GAME_MENU)
+            stats.LivesLost += lives; // game over resets the lives
+        else if (sim.Lives < lives)
+            stats.LivesLost += lives - sim.Lives;
+    }
+    ++stats.Games;
+    stats.Ticks += tick;
+    stats.PolicySeconds += std::chrono::duration<double>(policy).count();
+    if (sim.State == GAME_WIN)
+    {
+        ++stats.Cleared;
+        stats.ClearTimes.push_back(static_cast<float>(tick) / BATCH_TICK_RATE);
+    }
+    else if (sim.State == GAME_ACTIVE)
+    {
+        ++stats.TimedOut;
+        stats.BricksLeft += sim.Levels[0].Progress().Remaining;
+    }
+    else
+        stats.BricksLeft += bricksLeft;
+}
+
+// value below which the given fraction of the sorted values lie
+static float percentile(const std::vector<float>& sorted, float fraction)
+{
+    if (sorted.empty())
+        return 0.0f;
+    return sorted[std::min(sorted.size() - 1, static_cast<size_t>(fraction * sorted.size()))];
+}
+
+// Plays many seeded games per level on all cores with an automatic paddle
+// and reports how often and how fast each level is cleared, the lives it
+// costs and which powerups get caught. Run from the directory holding levels/.
+// With --autopilot the trajectory predicting Autopilot plays instead.
+// usage: Tools batch [--games n] [--threads n] [--max-minutes m] [--seed s] [--autopilot] [level files...]
+int Batch(int argc, char* argv[])
+{
+    unsigned int games = 1000, threads = 0, seed = 1;
+    float maxMinutes = 10.0f;
+    bool autopilot = false;
+    std::vector<std::string> files;
+    for (int i = 0; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--games") == 0 && i + 1 < argc)
+            games = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threads = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--max-minutes") == 0 && i + 1 < argc)
+            maxMinutes = static_cast<float>(std::atof(argv[++i]));
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            seed = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--autopilot") == 0)
+            autopilot = true;
+        else
+            files.push_back(argv[i]);
+    }
+    if (files.empty())
+        files = { "levels/one.lvl", "levels/two.lvl", "levels/three.lvl", "levels/four.lvl" };
+    std::vector<GameLevel> levels(files.size());
+    for (unsigned int i = 0; i < files.size(); ++i)
+    {
+        levels[i].Load(files[i].c_str(), 800, 300);
+        if (levels[i].Bricks.Size() == 0)
+        {
+            std::cout << "ERROR: no bricks in " << files[i] << std::endl;
+            return 1;
+        }
+    }
+    unsigned int maxTicks = static_cast<unsigned int>(maxMinutes * 60.0f * BATCH_TICK_RATE);
+
+    // one task per game; every worker adds to its own copy of the stats
+    WorkStealingPool pool(threads);
+    std::vector<std::vector<LevelStats>> results(pool.Size(), std::vector<LevelStats>(levels.size()));
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int game = 0; game < games; ++game)
+        for (unsigned int level = 0; level < levels.size(); ++level)
+            pool.Submit([&, game, level](unsigned int worker) {
+                Autopilot pilot;
+                PlayGame(levels[level], seed + game * static_cast<unsigned int>(levels.size()) + level, maxTicks,
+                         autopilot ? &pilot : nullptr, results[worker][level]);
+            });
+    pool.Wait();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    unsigned long ticks = 0;
+    double policySeconds = 0.0;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "level\tgames\tcleared\tclear time p10/p50/p90 (s)\tlives lost/game\tbricks left/game" << std::endl;
+    for (unsigned int level = 0; level < levels.size(); ++level)
+    {
+        LevelStats stats;
+        for (const std::vector<LevelStats>& worker : results)
+            stats.Merge(worker[level]);
+        ticks += stats.Ticks;
+        policySeconds += stats.PolicySeconds;
+        std::sort(stats.ClearTimes.begin(), stats.ClearTimes.end());
+        std::cout << files[level] << "\t" << stats.Games << "\t" << 100.0f * stats.Cleared / stats.Games << "%\t"
+                  << percentile(stats.ClearTimes, 0.1f) << " / " << percentile(stats.ClearTimes, 0.5f) << " / " << percentile(stats.ClearTimes, 0.9f) << "\t"
+                  << static_cast<float>(stats.LivesLost) / stats.Games << "\t" << static_cast<float>(stats.BricksLeft) / stats.Games << std::endl;
+        std::cout << "\tpowerups/game:";
+        for (const auto& count : stats.PowerUps)
+            std::cout << " " << count.first << " " << std::setprecision(2) << static_cast<float>(count.second) / stats.Games;
+        std::cout << std::setprecision(1) << std::endl;
+    }
+    std::cout << games * levels.size() << " games on " << pool.Size() << " threads in " << seconds << " s, "
+              << ticks / seconds / 1e6 << "M ticks/s" << std::endl;
+    if (autopilot)
+        std::cout << "autopilot: " << std::setprecision(3) << policySeconds * 1e6 / ticks << " us per decision" << std::endl;
+    return 0;
+}
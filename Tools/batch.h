@@ -0,0 +1,44 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "controller.h"
+#include "game_level.h"
+
+// Ticks per second the batch games are simulated at
+const unsigned int BATCH_TICK_RATE = 120;
+
+// Results of all games played on one level
+struct LevelStats {
+    unsigned int                        Games, Cleared;
+    unsigned int                        TimedOut;       // games neither cleared nor lost in time
+    unsigned long                       LivesLost, Ticks;
+    unsigned long                       BricksLeft;     // breakable bricks standing when a game ends
+    double                              PolicySeconds;  // spent deciding the paddle's keys
+    std::vector<float>                  ClearTimes;     // seconds of game time
+    std::map<std::string, unsigned int> PowerUps;       // activations per type
+
+    LevelStats() : Games(0), Cleared(0), TimedOut(0), LivesLost(0), Ticks(0), BricksLeft(0), PolicySeconds(0.0) { }
+    void Merge(const LevelStats& other)
+    {
+        this->Games += other.Games;
+        this->Cleared += other.Cleared;
+        this->TimedOut += other.TimedOut;
+        this->LivesLost += other.LivesLost;
+        this->Ticks += other.Ticks;
+        this->BricksLeft += other.BricksLeft;
+        this->PolicySeconds += other.PolicySeconds;
+        this->ClearTimes.insert(this->ClearTimes.end(), other.ClearTimes.begin(), other.ClearTimes.end());
+        for (const auto& count : other.PowerUps)
+            this->PowerUps[count.first] += count.second;
+    }
+};
+
+// plays one game on the level until it is cleared, lost or runs out of time,
+// with the batch runner's paddle policy or, when given, the controller on the paddle
+void PlayGame(const GameLevel& level, unsigned int seed, unsigned int maxTicks, Controller* controller, LevelStats& stats);
+
+#endif
@@ -0,0 +1,61 @@
+#include "tools.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "simulation.h"
+
+// average time of one tick, in microseconds, of a game serving the given
+// number of balls onto a stock-sized level with a paddle as wide as the
+// screen, so no ball is ever lost
+static double timeTicks(const GameLevel& level, unsigned int balls, CollisionMode mode, unsigned int ticks)
+{
+    Simulation start(800, 600);
+    start.Levels.push_back(level);
+    start.Collisions = mode;
+    start.ServeBalls = balls;
+    start.ResetPlayer();
+    Simulation sim = start;
+    SimInput input;
+    input.Launch = true;
+    std::chrono::steady_clock::duration total(0);
+    for (unsigned int tick = 0; tick < ticks; ++tick)
+    {
+        if (sim.State != GAME_ACTIVE)
+            sim = start; // level cleared: serve again
+        sim.Player.Position.x = 0.0f;
+        sim.Player.Size.x = 800.0f;
+        auto begin = std::chrono::steady_clock::now();
+        sim.Step(1.0f / 120.0f, input);
+        total += std::chrono::steady_clock::now() - begin;
+    }
+    return std::chrono::duration<double, std::micro>(total).count() / ticks;
+}
+
+// Measures how the cost of a simulation tick grows with the number of balls
+// in play, for both collision modes.
+// usage: Tools bench-balls [maxBalls] [ticks]
+int BenchBalls(int argc, char* argv[])
+{
+    unsigned int maxBalls = argc > 0 ? std::atoi(argv[0]) : MAX_BALLS;
+    unsigned int ticks = argc > 1 ? std::atoi(argv[1]) : 2400;
+    // a random level of stock size: 15 x 8 tiles with codes 0-5
+    std::mt19937 random(1234);
+    std::vector<std::vector<unsigned int>> tiles(8, std::vector<unsigned int>(15));
+    for (std::vector<unsigned int>& row : tiles)
+        for (unsigned int& tile : row)
+            tile = random() % 6;
+    GameLevel level;
+    level.Load(tiles, 800, 300);
+    std::cout << "balls\tdiscrete us/tick\tswept us/tick\tswept us/ball" << std::endl;
+    for (unsigned int balls = 1; balls <= maxBalls && balls <= MAX_BALLS; balls *= 4)
+    {
+        double discrete = timeTicks(level, balls, COLLISION_DISCRETE, ticks);
+        double swept = timeTicks(level, balls, COLLISION_SWEPT, ticks);
+        std::cout << balls << "\t" << discrete << "\t" << swept << "\t" << swept / balls << std::endl;
+    }
+    return 0;
+}
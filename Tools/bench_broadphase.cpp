@@ -0,0 +1,66 @@
+#include "tools.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "collision.h"
+#include "game_level.h"
+
+// Builds synthetic N x N levels with stock-sized tiles and measures how long
+// it takes to find the bricks touching a ball, once by scanning every brick
+// (what DoCollisions used to do) and once through the level's grid index.
+// usage: Tools bench-broadphase [maxSize]
+int BenchBroadphase(int argc, char* argv[])
+{
+    unsigned int maxSize = argc > 0 ? std::atoi(argv[0]) : 1000;
+    const unsigned int sizes[] = { 10, 32, 100, 316, 1000 };
+    // stock levels are 15 x 8 tiles on an 800 x 300 area
+    const float unitWidth = 800.0f / 15.0f, unitHeight = 300.0f / 8.0f;
+    std::mt19937 random(1234);
+    std::cout << "size\tbricks\tscan ns/query\tgrid ns/query\tspeedup" << std::endl;
+    for (unsigned int size : sizes)
+    {
+        if (size > maxSize)
+            break;
+        // random tile codes 0-5, about one in six cells empty
+        std::vector<std::vector<unsigned int>> tiles(size, std::vector<unsigned int>(size));
+        for (std::vector<unsigned int>& row : tiles)
+            for (unsigned int& tile : row)
+                tile = random() % 6;
+        GameLevel level;
+        level.Load(tiles, static_cast<unsigned int>(size * unitWidth), static_cast<unsigned int>(size * unitHeight));
+        // random ball positions over the whole level
+        unsigned int queries = std::max(100u, static_cast<unsigned int>(20000000 / level.Bricks.Size()));
+        std::uniform_real_distribution<float> x(0.0f, size * unitWidth), y(0.0f, size * unitHeight);
+        std::vector<BallObject> balls;
+        for (unsigned int i = 0; i < queries; ++i)
+            balls.push_back(BallObject(glm::vec2(x(random), y(random)), 12.5f, glm::vec2(0.0f)));
+
+        unsigned int scanHits = 0, gridHits = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (const BallObject& ball : balls)
+            for (unsigned int i = 0; i < level.Bricks.Size(); ++i)
+                if (!level.Bricks.IsDestroyed(i) && std::get<0>(CheckCollision(ball, level.Bricks.Positions[i], level.Bricks.Sizes[i])))
+                    ++scanHits;
+        auto middle = std::chrono::steady_clock::now();
+        for (const BallObject& ball : balls)
+            level.ForEachBrickIn(ball.Position, ball.Position + ball.Size, [&](unsigned int index) {
+                if (!level.Bricks.IsDestroyed(index) && std::get<0>(CheckCollision(ball, level.Bricks.Positions[index], level.Bricks.Sizes[index])))
+                    ++gridHits;
+            });
+        auto end = std::chrono::steady_clock::now();
+
+        double scan = std::chrono::duration<double, std::nano>(middle - start).count() / queries;
+        double grid = std::chrono::duration<double, std::nano>(end - middle).count() / queries;
+        std::cout << size << "x" << size << "\t" << level.Bricks.Size() << "\t" << scan << "\t" << grid << "\t" << scan / grid << "x" << std::endl;
+        if (scanHits != gridHits)
+        {
+            std::cout << "ERROR: scan found " << scanHits << " hits, grid found " << gridHits << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
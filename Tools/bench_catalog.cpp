@@ -0,0 +1,156 @@
+#include "tools.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "level_file.h"
+#include "level_generator.h"
+#include "simulation.h"
+
+// Scratch directory the level packs are written to, removed afterwards
+const char* const CATALOG_BENCH_DIRECTORY = "catalog_bench";
+const unsigned int CATALOG_BENCH_LEVELS_PER_PACK = 5;
+
+// writes packs level packs of generated levels of the given style below
+// directory, every other one compiled
+static bool writePacks(const std::string& directory, unsigned int packs, const LevelStyle& style)
+{
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+    std::vector<std::vector<unsigned int>> tiles;
+    for (unsigned int pack = 0; pack < packs; ++pack)
+    {
+        std::string path = directory + "/pack" + std::to_string(pack);
+        if (!std::filesystem::create_directories(path, error))
+            return false;
+        for (unsigned int level = 0; level < CATALOG_BENCH_LEVELS_PER_PACK; ++level)
+        {
+            GenerateLevel(style, pack * CATALOG_BENCH_LEVELS_PER_PACK + level, tiles);
+            std::string file = path + "/level" + std::to_string(level);
+            if (level % 2 ? !WriteCompiledLevel((file + ".lvb").c_str(), tiles) : !WriteLevelText((file + ".lvl").c_str(), tiles))
+                return false;
+        }
+    }
+    return true;
+}
+
+// milliseconds a scan of directory takes, the best of a few runs, and the bytes of levels it found
+static double timeScan(const std::string& directory, unsigned int& levels, uintmax_t& bytes)
+{
+    double best = 0.0;
+    for (unsigned int run = 0; run < 5; ++run)
+    {
+        LevelCatalog catalog(800, 300);
+        auto start = std::chrono::steady_clock::now();
+        catalog.Scan(directory, {});
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        best = run == 0 ? ms : std::min(best, ms);
+        levels = catalog.Size();
+        bytes = 0;
+        for (unsigned int i = 0; i < catalog.Size(); ++i)
+            bytes += catalog.At(i).Bytes;
+    }
+    return best;
+}
+
+// Writes scratch level packs and times scanning them: with growing numbers
+// of packs, and with levels a hundred times larger, which must not make the
+// scan any slower per level. Then steps through every level in the menu the
+// way a player would, lingering on each for the given milliseconds before
+// starting it, with a memory budget that holds only a few levels: the
+// levels kept besides the one played must stay within the budget, and every
+// level must come out as a direct load of its file would, with the size and
+// brick count the catalog read from the header of the compiled ones.
+// usage: Tools bench-catalog [linger ms] [budget levels]
+int BenchCatalog(int argc, char* argv[])
+{
+    int lingerMs = argc > 0 ? std::atoi(argv[0]) : 5;
+    unsigned int budgetLevels = argc > 1 ? std::max(1, std::atoi(argv[1])) : 4;
+    const std::string directory = CATALOG_BENCH_DIRECTORY;
+    LevelStyle small, large;
+    large.Width = 150;
+    large.Height = 80;
+    std::cout << "packs\tlevels\tlevel data (KB)\tscan (ms)\tscan per level (us)" << std::endl;
+    bool written = true;
+    unsigned int sizes[] = { 10, 100, 400 };
+    for (unsigned int i = 0; i < 4 && written; ++i)
+    {
+        unsigned int packs = i < 3 ? sizes[i] : 100;
+        written = writePacks(directory, packs, i < 3 ? small : large);
+        unsigned int levels = 0;
+        uintmax_t bytes = 0;
+        double ms = timeScan(directory, levels, bytes);
+        std::cout << packs << "\t" << levels << "\t" << bytes / 1024 << "\t" << ms << "\t" << ms * 1000.0 / std::max(1u, levels)
+                  << (i < 3 ? "" : "\tlarge levels") << std::endl;
+    }
+    if (!written)
+    {
+        std::cout << "ERROR: cannot write level packs to " << directory << std::endl;
+        std::error_code error;
+        std::filesystem::remove_all(directory, error);
+        return 1;
+    }
+
+    // the large packs are still on disk; the budget fits budgetLevels of them
+    Simulation sim(800, 600);
+    std::shared_ptr<LevelCatalog> catalog = std::make_shared<LevelCatalog>(sim.Width, sim.Height / 2);
+    catalog->Scan(directory, {});
+    sim.UseCatalog(catalog);
+    GameLevel probe;
+    probe.Load(sim.Catalog->At(0).File.c_str(), sim.Width, sim.Height / 2);
+    sim.LevelBudget = probe.Footprint() * budgetLevels;
+    sim.SelectLevel(0);
+    sim.State = GAME_MENU;
+    unsigned int levels = sim.Catalog->Size(), prefetched = 0, described = 0;
+    size_t worstResident = 0;
+    double startMs = 0.0, worstStartMs = 0.0;
+    bool same = true, withinBudget = true;
+    for (unsigned int step = 1; step <= levels; ++step)
+    {
+        // highlight the next level, look at it for a while, then start it
+        sim.ProcessKeys(0.0f, GAME_KEY_NEXT_LEVEL);
+        sim.ProcessKeys(0.0f, 0);
+        auto linger = std::chrono::steady_clock::now() + std::chrono::milliseconds(lingerMs);
+        while (std::chrono::steady_clock::now() < linger)
+            sim.AdoptLoadedLevels();
+        unsigned int level = sim.Level;
+        prefetched += sim.Levels[level].Bricks.Size() > 0;
+        auto start = std::chrono::steady_clock::now();
+        sim.ProcessKeys(0.0f, GAME_KEY_CONFIRM);
+        sim.ProcessKeys(0.0f, 0);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        startMs += ms;
+        worstStartMs = std::max(worstStartMs, ms);
+        GameLevel direct;
+        direct.Load(sim.Catalog->At(level).File.c_str(), sim.Width, sim.Height / 2);
+        const GameLevel& played = sim.Levels[level];
+        same = same && sim.State == GAME_ACTIVE && played.Grid == direct.Grid && played.Bricks.Kinds == direct.Bricks.Kinds
+            && played.Bricks.Positions == direct.Bricks.Positions && played.Bricks.Solid.Words == direct.Bricks.Solid.Words;
+        const LevelCatalog::Entry& entry = sim.Catalog->At(level);
+        if (entry.Bricks > 0)
+        {
+            ++described;
+            same = same && entry.Width == played.GridWidth && entry.Height == played.GridHeight && entry.Bricks == played.Bricks.Size();
+        }
+        size_t resident = 0;
+        for (unsigned int i = 0; i < levels; ++i)
+            if (i != level)
+                resident += sim.Levels[i].Footprint();
+        worstResident = std::max(worstResident, resident);
+        withinBudget = withinBudget && resident <= sim.LevelBudget;
+        sim.State = GAME_MENU;
+    }
+    std::filesystem::remove_all(directory);
+    std::cout << levels << " levels started, " << described << " described by their header, " << prefetched << " loaded ahead while highlighted; start "
+              << startMs / levels << " ms mean, " << worstStartMs << " ms worst" << std::endl;
+    std::cout << "resident besides the played level: " << worstResident / 1024 << " KB worst of a " << sim.LevelBudget / 1024
+              << " KB budget" << std::endl;
+    std::cout << "within budget: " << (withinBudget ? "yes" : "NO") << ", levels match direct loads: " << (same ? "yes" : "NO") << std::endl;
+    return withinBudget && same ? 0 : 1;
+}
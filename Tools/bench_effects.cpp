@@ -0,0 +1,110 @@
+#include "tools.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "pcg32.h"
+#include "simulation.h"
+
+// The effect bookkeeping the timers replaced: a list of running effects
+// that is scanned to find out whether a type is active and which ones ran out
+struct ScannedEffects {
+    std::vector<EffectTimer> Running;
+    double                   Clock = 0.0;
+
+    unsigned int Count(PowerUpType type) const
+    {
+        unsigned int count = 0;
+        for (const EffectTimer& effect : this->Running)
+            count += effect.Type == type;
+        return count;
+    }
+    bool IsActive(PowerUpType type) const
+    {
+        for (const EffectTimer& effect : this->Running)
+            if (effect.Type == type)
+                return true;
+        return false;
+    }
+    void Start(PowerUpType type, float duration)
+    {
+        // activation looked at two other types to pick the ball color
+        this->IsActive(POWERUP_SLOWMO);
+        this->IsActive(POWERUP_GHOST);
+        this->Running.push_back(EffectTimer{ this->Clock + duration, type });
+    }
+    // returns the number of types that stopped being active
+    unsigned int Advance(float dt)
+    {
+        this->Clock += dt;
+        unsigned int stopped = 0;
+        for (unsigned int i = 0; i < this->Running.size(); )
+        {
+            if (this->Running[i].Expiry <= this->Clock)
+            {
+                PowerUpType type = this->Running[i].Type;
+                this->Running.erase(this->Running.begin() + i);
+                stopped += !this->IsActive(type);
+            }
+            else
+                ++i;
+        }
+        return stopped;
+    }
+};
+
+// Piles up overlapping timed effects, as many as given, over the first five
+// seconds and ticks until all of them ran out. Checks that the timers agree
+// with the scanned list on every tick and times both.
+// usage: Tools bench-effects [maxEffects] [seed]
+int BenchEffects(int argc, char* argv[])
+{
+    unsigned int maxEffects = argc > 0 ? std::atoi(argv[0]) : 4096;
+    uint64_t seed = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1;
+    const float dt = 1.0f / 120.0f;
+    const unsigned int spreadTicks = 600;
+    std::vector<PowerUpType> timed;
+    for (unsigned int type = 0; type < POWERUP_TYPES; ++type)
+        if (POWERUP_TABLE[type].Duration > 0.0f)
+            timed.push_back(static_cast<PowerUpType>(type));
+    bool same = true;
+    std::cout << "effects\tticks\ttimers us/tick\tscan us/tick\tpeak running" << std::endl;
+    for (unsigned int effects = 16; effects <= maxEffects; effects *= 4)
+    {
+        Simulation sim(800, 600);
+        ScannedEffects scanned;
+        Pcg32 random(seed, RNG_STREAM_GAMEPLAY);
+        std::chrono::steady_clock::duration timers(0), scans(0);
+        unsigned int started = 0, ticks = 0, peak = 0;
+        while (started < effects || sim.Effects.Size() > 0 || !scanned.Running.empty())
+        {
+            // effects caught this tick
+            unsigned int due = ticks < spreadTicks ? static_cast<unsigned int>(static_cast<unsigned long>(effects) * (ticks + 1) / spreadTicks) : effects;
+            std::vector<PowerUpType> caught;
+            for (; started < due; ++started)
+                caught.push_back(timed[random.Below(static_cast<uint32_t>(timed.size()))]);
+            auto begin = std::chrono::steady_clock::now();
+            for (PowerUpType type : caught)
+                sim.ActivatePowerUp(type);
+            sim.UpdatePowerUps(dt);
+            auto middle = std::chrono::steady_clock::now();
+            for (PowerUpType type : caught)
+                scanned.Start(type, POWERUP_TABLE[type].Duration);
+            scanned.Advance(dt);
+            scans += std::chrono::steady_clock::now() - middle;
+            timers += middle - begin;
+            for (PowerUpType type : timed)
+                same = same && sim.Effects.Active[type] == scanned.Count(type);
+            if (sim.Effects.Size() > peak)
+                peak = sim.Effects.Size();
+            ++ticks;
+        }
+        same = same && !sim.Balls.Sticky && !sim.Balls.PassThrough && !sim.Balls.Ghost && !sim.Confuse && !sim.Chaos && !sim.SlowMo;
+        std::cout << effects << "\t" << ticks << "\t" << std::chrono::duration<double, std::micro>(timers).count() / ticks << "\t"
+                  << std::chrono::duration<double, std::micro>(scans).count() / ticks << "\t" << peak << std::endl;
+    }
+    std::cout << "timers match the scanned list: " << (same ? "yes" : "NO") << std::endl;
+    return same ? 0 : 1;
+}
@@ -0,0 +1,95 @@
+#include "tools.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "breakout_env.h"
+#include "pcg32.h"
+
+// random paddle keys for every instance
+static void randomActions(Pcg32& random, std::vector<unsigned char>& actions)
+{
+    for (unsigned char& action : actions)
+        action = static_cast<unsigned char>(random.Below(8));
+}
+
+// Steps a batch of games through the C environment interface with random
+// actions and reports steps and game ticks per second. First checks that
+// a batch stepped on one thread and one stepped on all cores observe the
+// same states. Run from the directory holding levels/.
+// usage: Tools bench-env [--count n] [--steps n] [--threads n] [--level n]
+int BenchEnv(int argc, char* argv[])
+{
+    unsigned int count = 4096, steps = 1000, threads = 0, level = 0;
+    for (int i = 0; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--count") == 0 && i + 1 < argc)
+            count = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--steps") == 0 && i + 1 < argc)
+            steps = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threads = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--level") == 0 && i + 1 < argc)
+            level = std::atoi(argv[++i]);
+    }
+    BreakoutEnv* env = breakout_env_create(count, level, threads);
+    BreakoutEnv* serial = breakout_env_create(count, level, 1);
+    if (!env || !serial)
+    {
+        std::cout << "ERROR: cannot load level " << level << std::endl;
+        return 1;
+    }
+    unsigned int features = breakout_env_features(), words = breakout_env_brick_words(env);
+    std::vector<unsigned char> actions(count), dones(count);
+    std::vector<float> rewards(count), observation(count * features), serialObservation(count * features);
+    std::vector<uint64_t> bricks(count * words), serialBricks(count * words);
+
+    // same seeds and actions on one thread and on all of them
+    Pcg32 random(1, RNG_STREAM_GAMEPLAY);
+    breakout_env_reset(env, 1);
+    breakout_env_reset(serial, 1);
+    for (unsigned int step = 0; step < 500; ++step)
+    {
+        randomActions(random, actions);
+        breakout_env_step(env, actions.data(), nullptr, nullptr);
+        breakout_env_step(serial, actions.data(), nullptr, nullptr);
+    }
+    breakout_env_observe(env, observation.data(), bricks.data());
+    breakout_env_observe(serial, serialObservation.data(), serialBricks.data());
+    bool same = observation == serialObservation && bricks == serialBricks;
+    std::cout << count << " games, " << features << " features and " << words << " brick words each; threaded matches serial: "
+              << (same ? "yes" : "NO") << std::endl;
+    breakout_env_destroy(serial);
+
+    // throughput
+    breakout_env_reset(env, 2);
+    double reward = 0.0;
+    unsigned long finished = 0;
+    std::chrono::steady_clock::duration stepping(0), observing(0);
+    for (unsigned int step = 0; step < steps; ++step)
+    {
+        randomActions(random, actions);
+        auto start = std::chrono::steady_clock::now();
+        breakout_env_step(env, actions.data(), rewards.data(), dones.data());
+        auto stepped = std::chrono::steady_clock::now();
+        breakout_env_observe(env, observation.data(), bricks.data());
+        observing += std::chrono::steady_clock::now() - stepped;
+        stepping += stepped - start;
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            reward += rewards[i];
+            finished += dones[i];
+        }
+    }
+    double stepSeconds = std::chrono::duration<double>(stepping).count();
+    double observeSeconds = std::chrono::duration<double>(observing).count();
+    std::cout << "step: " << stepSeconds * 1e6 / steps << " us per batch, " << static_cast<double>(count) * steps / stepSeconds / 1e6
+              << "M game ticks/s" << std::endl;
+    std::cout << "observe: " << observeSeconds * 1e6 / steps << " us per batch" << std::endl;
+    std::cout << finished << " games finished, mean reward per step " << reward / (static_cast<double>(count) * steps) << std::endl;
+    breakout_env_destroy(env);
+    return same ? 0 : 1;
+}
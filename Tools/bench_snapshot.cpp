@@ -0,0 +1,94 @@
+#include "tools.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+#include "snapshot.h"
+
+// plays ticks with the paddle chasing the first ball, missing it by up to
+// 40 pixels either way as drawn from input; launches right away
+static void play(Simulation& sim, Pcg32& input, unsigned int ticks)
+{
+    for (unsigned int tick = 0; tick < ticks; ++tick)
+    {
+        SimInput keys;
+        keys.Launch = true;
+        float center = sim.Player.Position.x + sim.Player.Size.x / 2.0f;
+        float target = sim.Balls.Size() > 0 ? sim.Balls.Positions[0].x + sim.Balls.Radius : center;
+        target += static_cast<float>(input.Below(81)) - 40.0f;
+        keys.Left = target < center - 5.0f;
+        keys.Right = target > center + 5.0f;
+        sim.Step(1.0f / 120.0f, keys);
+    }
+}
+
+// whether two simulations are in the same state, as far as the snapshot covers it
+static bool sameState(const Simulation& a, const Simulation& b)
+{
+    return a.State == b.State && a.Level == b.Level && a.Lives == b.Lives
+        && a.Random.State == b.Random.State && a.Player.Position == b.Player.Position
+        && a.Balls.Positions == b.Balls.Positions && a.Balls.Velocities == b.Balls.Velocities
+        && a.Levels[a.Level].Bricks.Destroyed.Words == b.Levels[b.Level].Bricks.Destroyed.Words
+        && a.Levels[a.Level].Bricks.Positions == b.Levels[b.Level].Bricks.Positions
+        && a.PowerUps.size() == b.PowerUps.size() && a.Effects.Heap.size() == b.Effects.Heap.size();
+}
+
+// Checks that a game restored from a snapshot plays on exactly like the
+// original, then times saving and restoring a game on each stock level
+// against copying the whole Simulation. Run from the directory holding levels/.
+// usage: Tools bench-snapshot [iterations]
+int BenchSnapshot(int argc, char* argv[])
+{
+    unsigned int iterations = argc > 0 ? std::atoi(argv[0]) : 100000;
+    std::unique_ptr<SimSnapshot> snapshot(new SimSnapshot());
+    std::cout << "level\tbricks\tballs\tpowerups\tsave ns\trestore ns\tcopy ns\tbranch" << std::endl;
+    for (unsigned int level = 0; level < 4; ++level)
+    {
+        Simulation sim(800, 600);
+        sim.Seed(level);
+        sim.LoadLevels();
+        sim.SelectLevel(level);
+        Pcg32 input(level, RNG_STREAM_GAMEPLAY);
+        play(sim, input, 2400);
+        if (!snapshot->Save(sim))
+        {
+            std::cout << "ERROR: level " << level << " does not fit in a snapshot" << std::endl;
+            return 1;
+        }
+        // branch: play on from the snapshot twice with the same keys
+        Pcg32 branchInput = input;
+        Simulation original = sim;
+        play(original, branchInput, 2400);
+        branchInput = input;
+        play(sim, input, 600); // wander off first, so the restore has something to undo
+        sim.Levels[level].Reset(glm::vec2(0.0f, sim.Height / 4.0f)); // and move the level, the way versus does
+        snapshot->Restore(sim);
+        play(sim, branchInput, 2400);
+        bool branch = sameState(original, sim);
+
+        snapshot->Restore(sim);
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned int i = 0; i < iterations; ++i)
+            snapshot->Save(sim);
+        auto saved = std::chrono::steady_clock::now();
+        for (unsigned int i = 0; i < iterations; ++i)
+            snapshot->Restore(sim);
+        auto restored = std::chrono::steady_clock::now();
+        unsigned int copies = iterations / 10 + 1;
+        for (unsigned int i = 0; i < copies; ++i)
+            original = sim;
+        auto copied = std::chrono::steady_clock::now();
+
+        std::cout << level << "\t" << sim.Levels[level].Bricks.Size() << "\t" << sim.Balls.Size() << "\t" << sim.PowerUps.size() << "\t"
+                  << std::chrono::duration<double, std::nano>(saved - start).count() / iterations << "\t"
+                  << std::chrono::duration<double, std::nano>(restored - saved).count() / iterations << "\t"
+                  << std::chrono::duration<double, std::nano>(copied - restored).count() / copies << "\t"
+                  << (branch ? "same" : "DIFFERENT") << std::endl;
+        if (!branch)
+            return 1;
+    }
+    std::cout << "snapshot size " << sizeof(SimSnapshot) << " bytes" << std::endl;
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include "tools.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "autopilot.h"
+#include "simulation.h"
+
+// Tick rate and screen the played part of the benchmark uses
+const float STREAM_BENCH_DT = 1.0f / 120.0f;
+const unsigned int STREAM_BENCH_WIDTH = 800, STREAM_BENCH_HEIGHT = 600;
+
+// Scrolls a streamed level through the given number of rows, one row per
+// call, and checks that it never grows and that every breakable brick of
+// the rows that left play was counted as dropped. Then lets the autopilot
+// play the level scrolling fast and compares the cost of early and late
+// ticks. Streams endless generated rows, or a compiled level file.
+// usage: Tools bench-stream [rows] [compiled level file]
+int BenchStream(int argc, char* argv[])
+{
+    uint64_t rows = argc > 0 ? std::strtoull(argv[0], nullptr, 10) : 1000000;
+    std::shared_ptr<const ChunkSource> source;
+    if (argc > 1)
+    {
+        std::shared_ptr<CompiledLevelRows> file = std::make_shared<CompiledLevelRows>(argv[1]);
+        if (!file->IsOpen() || file->Columns() == 0)
+        {
+            std::cout << "ERROR: " << argv[1] << " is not a compiled level" << std::endl;
+            return 1;
+        }
+        source = file;
+    }
+    else
+        source = std::make_shared<GeneratedRows>(15, 1);
+    // paging: the first row rests on the middle of the screen, rows leave play at the paddle
+    float rowHeight = STREAM_BENCH_HEIGHT / 2.0f / STREAM_VISIBLE_ROWS;
+    float bottom = STREAM_BENCH_HEIGHT / 2.0f, floor = STREAM_BENCH_HEIGHT - PLAYER_SIZE.y;
+    GameLevel level;
+    level.Stream(source, STREAM_BENCH_WIDTH, rowHeight, bottom);
+    unsigned int bricks = level.Bricks.Size();
+    size_t bytes = level.Footprint();
+    uint64_t dropped = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < rows; ++i)
+        dropped += level.Scroll(rowHeight, floor);
+    double pagingNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / rows;
+    bool constant = level.Bricks.Size() == bricks && level.Footprint() == bytes;
+    // row r left play once its bottom edge, at bottom + rows * rowHeight - r * rowHeight, passed the floor
+    uint64_t expected = 0;
+    std::vector<unsigned char> kinds(source->Columns());
+    for (uint64_t r = 0; r < source->Rows() && bottom + (rows - r) * rowHeight > floor; ++r)
+    {
+        source->Row(r, kinds.data());
+        for (unsigned char kind : kinds)
+            expected += kind != 0 && kind != BRICK_KIND_SOLID;
+    }
+    bool counted = dropped == expected;
+    std::cout << source->Columns() << " columns, " << bricks << " resident bricks, " << bytes << " bytes" << std::endl;
+    std::cout << "paging: " << rows << " rows, " << pagingNs << " ns/row" << std::endl;
+    std::cout << "dropped bricks: " << dropped << " of " << expected << std::endl;
+    // playing: a row scrolls in every 16 ticks, and the game has lives enough
+    // never to end, so the late ticks are played thousands of rows in
+    Simulation sim(STREAM_BENCH_WIDTH, STREAM_BENCH_HEIGHT);
+    sim.Seed(1);
+    sim.Level = sim.AddStreamedLevel(source, rowHeight * 7.5f);
+    sim.State = GAME_ACTIVE;
+    const unsigned int lives = 1000000;
+    sim.Lives = lives;
+    bytes = sim.Levels[sim.Level].Footprint();
+    Autopilot autopilot;
+    const unsigned int ticks = 120000, window = ticks / 10;
+    std::chrono::steady_clock::duration early(0), late(0);
+    unsigned int played = 0;
+    for (; played < ticks && sim.State == GAME_ACTIVE; ++played)
+    {
+        SimInput input = PaddleInput(autopilot.Keys(sim, PLAYER_ONE, STREAM_BENCH_DT));
+        start = std::chrono::steady_clock::now();
+        sim.Step(STREAM_BENCH_DT, input);
+        std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+        if (played < window)
+            early += elapsed;
+        else if (played >= ticks - window)
+            late += elapsed;
+    }
+    constant = constant && sim.Levels[sim.Level].Bricks.Size() == bricks && sim.Levels[sim.Level].Footprint() == bytes;
+    if (played < ticks)
+        std::cout << "playing: the level ran out after " << played << " ticks" << std::endl;
+    else
+        std::cout << "playing: " << ticks << " ticks, " << ticks * STREAM_BENCH_DT * 7.5f << " rows, " << lives - sim.Lives << " lives lost, "
+                  << std::chrono::duration<double, std::micro>(early).count() / window << " us/tick early, "
+                  << std::chrono::duration<double, std::micro>(late).count() / window << " us/tick late" << std::endl;
+    std::cout << "constant memory: " << (constant ? "yes" : "NO") << std::endl;
+    return constant && counted ? 0 : 1;
+}
@@ -0,0 +1,170 @@
+#include "tools.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "game_level.h"
+#include "level_file.h"
+#include "level_watcher.h"
+#include "pcg32.h"
+#include "simulation.h"
+
+// Area the stock levels are laid out in
+const unsigned int RELOAD_LEVEL_WIDTH = 800, RELOAD_LEVEL_HEIGHT = 300;
+// Longest a change may take to come through the watcher
+const double RELOAD_TIMEOUT_MS = 2000.0;
+
+// whether a patched level holds the bricks a fresh load of the tiles would,
+// each destroyed exactly when it was destroyed before and its cell wasn't edited
+static bool matchesTiles(const GameLevel& level, const std::vector<std::vector<unsigned int>>& tiles,
+                         const std::vector<bool>& destroyed, const std::vector<bool>& edited)
+{
+    GameLevel fresh;
+    fresh.Load(tiles, RELOAD_LEVEL_WIDTH, RELOAD_LEVEL_HEIGHT, level.Origin);
+    if (fresh.Grid.size() != level.Grid.size() || fresh.Bricks.Size() != level.Bricks.Size())
+        return false;
+    BrickProgress progress;
+    for (unsigned int cell = 0; cell < level.Grid.size(); ++cell)
+    {
+        int expected = fresh.Grid[cell], actual = level.Grid[cell];
+        if ((expected < 0) != (actual < 0))
+            return false;
+        if (actual < 0)
+            continue;
+        const BrickStore& bricks = level.Bricks;
+        if (bricks.Kinds[actual] != fresh.Bricks.Kinds[expected] || bricks.Positions[actual] != fresh.Bricks.Positions[expected]
+            || bricks.IsSolid(actual) != fresh.Bricks.IsSolid(expected) || bricks.IsDestroyed(actual) != (destroyed[cell] && !edited[cell]))
+            return false;
+        unsigned char kind = bricks.Kinds[actual];
+        if (kind != BRICK_KIND_SOLID)
+        {
+            ++progress.Total;
+            ++progress.TotalByKind[kind];
+            progress.Remaining += !bricks.IsDestroyed(actual);
+            progress.RemainingByKind[kind] += !bricks.IsDestroyed(actual);
+        }
+    }
+    const BrickProgress& kept = level.Progress();
+    return kept.Total == progress.Total && kept.Remaining == progress.Remaining
+        && std::equal(kept.TotalByKind, kept.TotalByKind + BRICK_KIND_MAX + 1, progress.TotalByKind)
+        && std::equal(kept.RemainingByKind, kept.RemainingByKind + BRICK_KIND_MAX + 1, progress.RemainingByKind);
+}
+
+// whether a catalog level the menu read ahead of time comes out with the
+// tiles of an edit that was reloaded before the level was taken
+static bool checkPrefetchedReload(std::vector<std::vector<unsigned int>> tiles)
+{
+    const std::string directory = "reload_check_catalog", file = directory + "/level.lvl";
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (!WriteLevelText(file.c_str(), tiles))
+        return false;
+    Simulation sim(RELOAD_LEVEL_WIDTH, RELOAD_LEVEL_HEIGHT * 2);
+    std::shared_ptr<LevelCatalog> catalog = std::make_shared<LevelCatalog>(sim.Width, sim.Height / 2);
+    catalog->Scan(directory, {});
+    sim.UseCatalog(catalog);
+    // the edit comes in while the read ahead copy is done or still being read
+    catalog->Prefetch(0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    tiles[0][0] = tiles[0][0] == 0 ? 2 : 0;
+    WriteLevelText(file.c_str(), tiles);
+    sim.ReloadLevel(file, tiles);
+    sim.AdoptLoadedLevels();
+    sim.SelectLevel(0);
+    GameLevel fresh;
+    fresh.Load(tiles, sim.Width, sim.Height / 2);
+    bool same = sim.Levels[0].Grid == fresh.Grid && sim.Levels[0].Bricks.Kinds == fresh.Bricks.Kinds;
+    std::filesystem::remove_all(directory, error);
+    return same;
+}
+
+// Copies a level into a scratch file, destroys a third of its bricks and
+// then edits random cells of the file over and over, saving it in place and
+// by renaming a new file over it in turns. Every edit has to come through
+// the watcher and be patched into the level without disturbing the
+// destroyed state of the cells left alone. Reports how long changes took
+// to come through and to patch. Last checks that an edit reaches a level
+// the menu read ahead of time as well.
+// usage: Tools check-reload [level file] [edits]
+int CheckReload(int argc, char* argv[])
+{
+    const char* source = argc > 0 ? argv[0] : "levels/one.lvl";
+    unsigned int edits = argc > 1 ? std::atoi(argv[1]) : 20;
+    const std::string file = "reload_check.lvl", renamed = "reload_check.lvl.new";
+    std::vector<std::vector<unsigned int>> tiles;
+    if (!ReadLevelTiles(source, tiles) || tiles.empty() || !WriteLevelText(file.c_str(), tiles))
+    {
+        std::cout << "ERROR: cannot copy " << source << std::endl;
+        return 1;
+    }
+    GameLevel level;
+    level.Load(file.c_str(), RELOAD_LEVEL_WIDTH, RELOAD_LEVEL_HEIGHT);
+    unsigned int width = level.GridWidth, height = level.GridHeight;
+    std::vector<bool> destroyed(width * height, false);
+    for (unsigned int cell = 0; cell < level.Grid.size(); cell += 3)
+        if (level.Grid[cell] >= 0 && level.Bricks.Destroy(level.Grid[cell]))
+            destroyed[cell] = true;
+    std::vector<bool> edited(width * height, false);
+    LevelWatcher watcher({ file });
+    Pcg32 random(1, RNG_STREAM_GAMEPLAY);
+    bool same = true;
+    unsigned int arrived = 0, changed = 0;
+    double latencyMs = 0.0, worstMs = 0.0, patchUs = 0.0;
+    for (unsigned int edit = 0; edit < edits; ++edit)
+    {
+        // a few cells get another tile code, which may empty or fill them;
+        // only cells whose brick kind changed count as edited
+        std::vector<std::vector<unsigned int>> before = tiles;
+        for (unsigned int i = 0; i < 3; ++i)
+            tiles[random.Below(height)][random.Below(width)] = random.Below(BRICK_KIND_MAX);
+        for (unsigned int cell = 0; cell < width * height; ++cell)
+            if (BrickKind(tiles[cell / width][cell % width]) != BrickKind(before[cell / width][cell % width]))
+                edited[cell] = true;
+        // wait for the watcher to settle, so every save is its own change
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        auto saved = std::chrono::steady_clock::now();
+        if (edit % 2 == 0)
+            WriteLevelText(file.c_str(), tiles);
+        else
+        {
+            WriteLevelText(renamed.c_str(), tiles);
+            std::remove(file.c_str());
+            std::rename(renamed.c_str(), file.c_str());
+        }
+        std::vector<LevelWatcher::Change> changes;
+        double waitedMs = 0.0;
+        while (!watcher.TakeChanges(changes) && waitedMs < RELOAD_TIMEOUT_MS)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            waitedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - saved).count();
+        }
+        if (changes.empty())
+            continue;
+        ++arrived;
+        latencyMs += waitedMs;
+        worstMs = std::max(worstMs, waitedMs);
+        auto start = std::chrono::steady_clock::now();
+        for (const LevelWatcher::Change& change : changes)
+            changed += level.Patch(change.Tiles, RELOAD_LEVEL_WIDTH, RELOAD_LEVEL_HEIGHT);
+        patchUs += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        same = same && changes.back().Tiles == tiles && matchesTiles(level, tiles, destroyed, edited);
+    }
+    std::remove(file.c_str());
+    bool prefetched = checkPrefetchedReload(tiles);
+    same = same && arrived == edits;
+    std::cout << source << ": " << edits << " edits, " << arrived << " came through, " << changed << " cells changed" << std::endl;
+    std::cout << "watcher latency: " << (arrived ? latencyMs / arrived : 0.0) << " ms mean, " << worstMs << " ms worst" << std::endl;
+    std::cout << "patch: " << (arrived ? patchUs / arrived : 0.0) << " us" << std::endl;
+    std::cout << "patched levels match: " << (same ? "yes" : "NO") << std::endl;
+    std::cout << "levels read ahead get the edit: " << (prefetched ? "yes" : "NO") << std::endl;
+    return same && prefetched ? 0 : 1;
+}
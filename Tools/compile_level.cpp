@@ -0,0 +1,119 @@
+#include "tools.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "game_level.h"
+#include "level_file.h"
+#include "mapped_file.h"
+#include "pcg32.h"
+
+// Area the stock levels are laid out in: the top half of an 800 x 600 screen
+const unsigned int STOCK_LEVEL_WIDTH = 800, STOCK_LEVEL_HEIGHT = 300;
+
+// whether two loaded levels hold the same bricks in the same places
+static bool sameLevel(const GameLevel& a, const GameLevel& b)
+{
+    return a.GridWidth == b.GridWidth && a.GridHeight == b.GridHeight && a.UnitSize == b.UnitSize && a.Grid == b.Grid
+        && a.Bricks.Positions == b.Bricks.Positions && a.Bricks.Sizes == b.Bricks.Sizes && a.Bricks.Kinds == b.Bricks.Kinds
+        && a.Bricks.Solid.Words == b.Bricks.Solid.Words && a.Bricks.Destroyed.Words == b.Bricks.Destroyed.Words
+        && a.Bricks.Progress.Total == b.Bricks.Progress.Total
+        && std::equal(a.Bricks.Progress.TotalByKind, a.Bricks.Progress.TotalByKind + BRICK_KIND_MAX + 1, b.Bricks.Progress.TotalByKind);
+}
+
+// Compiles a text level into the binary format GameLevel maps into memory,
+// then loads both and checks they lay out the same bricks. With --text a
+// compiled level is turned back into text instead.
+// usage: Tools compile-level [--text] <input> <output>
+int CompileLevel(int argc, char* argv[])
+{
+    bool toText = argc > 0 && std::strcmp(argv[0], "--text") == 0;
+    if (argc != (toText ? 3 : 2))
+    {
+        std::cout << "usage: Tools compile-level [--text] <input> <output>" << std::endl;
+        return 1;
+    }
+    const char* input = argv[toText ? 1 : 0];
+    const char* output = argv[toText ? 2 : 1];
+    std::vector<std::vector<unsigned int>> tiles;
+    if (toText)
+    {
+        MappedFile compiled(input);
+        if (!ReadCompiledTiles(compiled.Data(), compiled.Size(), tiles) || !WriteLevelText(output, tiles))
+        {
+            std::cout << "ERROR: cannot turn " << input << " into text" << std::endl;
+            return 1;
+        }
+    }
+    else if (!ReadLevelText(input, tiles) || tiles.empty() || !WriteCompiledLevel(output, tiles))
+    {
+        std::cout << "ERROR: cannot compile " << input << std::endl;
+        return 1;
+    }
+    GameLevel source, target;
+    source.Load(input, STOCK_LEVEL_WIDTH, STOCK_LEVEL_HEIGHT);
+    target.Load(output, STOCK_LEVEL_WIDTH, STOCK_LEVEL_HEIGHT);
+    bool same = sameLevel(source, target);
+    std::cout << input << " -> " << output << ": " << target.GridWidth << " x " << target.GridHeight << " tiles, "
+              << target.Bricks.Size() << " bricks, same layout: " << (same ? "yes" : "NO") << std::endl;
+    return same ? 0 : 1;
+}
+
+// Writes a random square level with the given number of tiles per side as
+// text and compiled, then times loading each and resetting the loaded level
+// after every other brick was destroyed. Scratch files go to the current
+// directory and are removed afterwards.
+// usage: Tools bench-level-load [tiles per side] [loads]
+int BenchLevelLoad(int argc, char* argv[])
+{
+    unsigned int side = argc > 0 ? std::atoi(argv[0]) : 1000;
+    unsigned int loads = argc > 1 ? std::atoi(argv[1]) : 10;
+    const char* text = "bench_level.lvl";
+    const char* compiled = "bench_level.lvb";
+    Pcg32 random(1, RNG_STREAM_GAMEPLAY);
+    std::vector<std::vector<unsigned int>> tiles(side, std::vector<unsigned int>(side));
+    for (std::vector<unsigned int>& row : tiles)
+        for (unsigned int& tile : row)
+            tile = random.Below(BRICK_KIND_MAX);
+    if (!WriteLevelText(text, tiles) || !WriteCompiledLevel(compiled, tiles))
+    {
+        std::cout << "ERROR: cannot write scratch levels" << std::endl;
+        return 1;
+    }
+    // one pixel per tile is enough to tell the layouts apart
+    GameLevel fromText, fromCompiled;
+    auto start = std::chrono::steady_clock::now();
+    fromText.Load(text, side, side);
+    double textMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < loads; ++i)
+        fromCompiled.Load(compiled, side, side);
+    double compiledMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / loads;
+    bool same = sameLevel(fromText, fromCompiled);
+    // resets restore the bricks in place
+    BrickStore& bricks = fromCompiled.Bricks;
+    unsigned int resets = loads * 100;
+    std::chrono::steady_clock::duration resetting(0);
+    for (unsigned int i = 0; i < resets; ++i)
+    {
+        for (unsigned int brick = i % 2; brick < bricks.Size(); brick += 2)
+            bricks.Destroy(brick);
+        start = std::chrono::steady_clock::now();
+        fromCompiled.Reset(fromCompiled.Origin);
+        resetting += std::chrono::steady_clock::now() - start;
+    }
+    same = same && sameLevel(fromText, fromCompiled);
+    double resetNs = std::chrono::duration<double, std::nano>(resetting).count() / resets;
+    std::cout << side << " x " << side << " tiles, " << fromCompiled.Bricks.Size() << " bricks" << std::endl;
+    std::cout << "text: " << textMs << " ms" << std::endl;
+    std::cout << "compiled: " << compiledMs << " ms, " << textMs / compiledMs << "x faster" << std::endl;
+    std::cout << "reset: " << resetNs << " ns" << std::endl;
+    std::cout << "same layout: " << (same ? "yes" : "NO") << std::endl;
+    std::remove(text);
+    std::remove(compiled);
+    return same ? 0 : 1;
+}
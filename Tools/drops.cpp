@@ -0,0 +1,49 @@
+#include "tools.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "simulation.h"
+
+// Prints what destroyed bricks drop with the chances of a powerups.cfg
+// file: the chance configured for each powerup, the chance the alias table
+// actually gives it after rounding, and how often it came up in a run of
+// sampled drops. Without a file the built-in chances are shown.
+// usage: Tools drops [file] [--samples n]
+int Drops(int argc, char* argv[])
+{
+    const char* file = nullptr;
+    unsigned long samples = 10000000;
+    for (int i = 0; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--samples") == 0 && i + 1 < argc)
+            samples = std::strtoul(argv[++i], nullptr, 10);
+        else
+            file = argv[i];
+    }
+    Simulation sim(800, 600);
+    if (file && !sim.LoadDropChances(file))
+    {
+        std::cout << "ERROR: cannot read drop chances from " << file << std::endl;
+        return 1;
+    }
+    float total = 0.0f;
+    for (float chance : sim.DropChances)
+        total += chance;
+    std::vector<unsigned long> counts(POWERUP_TYPES + 1, 0);
+    for (unsigned long i = 0; i < samples; ++i)
+        ++counts[sim.Drops.Sample(sim.Random)];
+    std::cout << std::fixed << std::setprecision(4) << std::left << std::setw(24) << "powerup" << "chance %\ttable %\t\tsampled %" << std::endl;
+    for (unsigned int outcome = 0; outcome <= POWERUP_TYPES; ++outcome)
+    {
+        const char* name = outcome < POWERUP_TYPES ? POWERUP_TABLE[outcome].Name : "(nothing)";
+        float chance = outcome < POWERUP_TYPES ? sim.DropChances[outcome] : 100.0f - total;
+        std::cout << std::left << std::setw(24) << name << chance << "\t\t" << sim.Drops.Probability(outcome) * 100.0 << "\t\t"
+                  << 100.0 * counts[outcome] / samples << std::endl;
+    }
+    std::cout << "any powerup: " << total << "% of bricks, one random draw per brick" << std::endl;
+    return 0;
+}
@@ -0,0 +1,152 @@
+#include "tools.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "batch.h"
+#include "level_file.h"
+#include "level_generator.h"
+#include "work_stealing_pool.h"
+
+// A generated level and how it played
+struct Candidate {
+    uint64_t                               Seed;
+    std::vector<std::vector<unsigned int>> Tiles;
+    GameLevel                              Level;
+    unsigned int                           Trapped;
+    LevelStats                             Stats;
+};
+
+// Generates levels from consecutive seeds and scores each by playing it
+// many times with the batch runner's paddle on all cores: how often it is
+// cleared within the time limit, how long clearing takes and how many
+// bricks solid ones seal off. Levels with sealed off bricks are dropped
+// without playing them; the ones whose clear rate falls into the band are
+// written to the output directory as generated_<seed>.lvl.
+// usage: Tools generate-levels [--count n] [--candidates n] [--seed s] [--plays n] [--max-minutes m]
+//        [--min-clear f] [--max-clear f] [--width w] [--height h] [--fill f] [--solid f]
+//        [--unmirrored] [--unbanded] [--threads n] [--out dir]
+int GenerateLevels(int argc, char* argv[])
+{
+    unsigned int count = 10, candidates = 500, plays = 16, threads = 0;
+    uint64_t seed = 1;
+    float maxMinutes = 5.0f, minClear = 0.25f, maxClear = 0.9f;
+    LevelStyle style;
+    std::string out = ".";
+    for (int i = 0; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--count") == 0 && i + 1 < argc)
+            count = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--candidates") == 0 && i + 1 < argc)
+            candidates = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--plays") == 0 && i + 1 < argc)
+            plays = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--max-minutes") == 0 && i + 1 < argc)
+            maxMinutes = static_cast<float>(std::atof(argv[++i]));
+        else if (std::strcmp(argv[i], "--min-clear") == 0 && i + 1 < argc)
+            minClear = static_cast<float>(std::atof(argv[++i]));
+        else if (std::strcmp(argv[i], "--max-clear") == 0 && i + 1 < argc)
+            maxClear = static_cast<float>(std::atof(argv[++i]));
+        else if (std::strcmp(argv[i], "--width") == 0 && i + 1 < argc)
+            style.Width = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--height") == 0 && i + 1 < argc)
+            style.Height = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--fill") == 0 && i + 1 < argc)
+            style.Fill = static_cast<float>(std::atof(argv[++i]));
+        else if (std::strcmp(argv[i], "--solid") == 0 && i + 1 < argc)
+            style.Solid = static_cast<float>(std::atof(argv[++i]));
+        else if (std::strcmp(argv[i], "--unmirrored") == 0)
+            style.Mirrored = false;
+        else if (std::strcmp(argv[i], "--unbanded") == 0)
+            style.Banded = false;
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threads = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+            out = argv[++i];
+        else
+        {
+            std::cout << "Unknown option: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+    unsigned int maxTicks = static_cast<unsigned int>(maxMinutes * 60.0f * BATCH_TICK_RATE);
+
+    // candidates are scored in rounds a few per worker large, so the search
+    // stops soon after enough levels were kept; one task per play
+    WorkStealingPool pool(threads);
+    unsigned int roundSize = pool.Size() * 4;
+    std::vector<Candidate> round(roundSize);
+    std::vector<std::vector<LevelStats>> results(pool.Size(), std::vector<LevelStats>(roundSize));
+    unsigned int generated = 0, unplayable = 0, played = 0, kept = 0;
+    unsigned long ticks = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "seed\tbricks\ttrapped\tcleared\tmean clear time (s)\ttimed out\tbricks left/game" << std::endl;
+    while (kept < count && generated < candidates)
+    {
+        unsigned int size = 0;
+        for (; size < roundSize && generated < candidates; ++generated)
+        {
+            Candidate& candidate = round[size];
+            candidate.Seed = seed + generated;
+            GenerateLevel(style, candidate.Seed, candidate.Tiles);
+            candidate.Trapped = CountTrappedBricks(candidate.Tiles);
+            candidate.Level.Load(candidate.Tiles, 800, 300);
+            if (candidate.Trapped > 0 || candidate.Level.Progress().Total == 0)
+            {
+                std::cout << candidate.Seed << "\t" << candidate.Level.Progress().Total << "\t" << candidate.Trapped << "\t-\t-\t-\t-\tunplayable" << std::endl;
+                ++unplayable;
+                continue;
+            }
+            for (std::vector<LevelStats>& worker : results)
+                worker[size] = LevelStats();
+            for (unsigned int play = 0; play < plays; ++play)
+                pool.Submit([&, size, play](unsigned int worker) {
+                    PlayGame(round[size].Level, static_cast<unsigned int>(round[size].Seed * plays + play), maxTicks, nullptr, results[worker][size]);
+                });
+            ++size;
+        }
+        pool.Wait();
+        played += size;
+        for (unsigned int i = 0; i < size; ++i)
+        {
+            Candidate& candidate = round[i];
+            candidate.Stats = LevelStats();
+            for (const std::vector<LevelStats>& worker : results)
+                candidate.Stats.Merge(worker[i]);
+            const LevelStats& stats = candidate.Stats;
+            ticks += stats.Ticks;
+            float cleared = static_cast<float>(stats.Cleared) / stats.Games;
+            float clearTime = 0.0f;
+            for (float time : stats.ClearTimes)
+                clearTime += time / stats.ClearTimes.size();
+            unsigned int unfinished = stats.Games - stats.Cleared;
+            bool keep = kept < count && cleared >= minClear && cleared <= maxClear;
+            std::cout << candidate.Seed << "\t" << candidate.Level.Progress().Total << "\t" << candidate.Trapped << "\t"
+                      << 100.0f * cleared << "%\t" << clearTime << "\t" << 100.0f * stats.TimedOut / stats.Games << "%\t"
+                      << (unfinished > 0 ? static_cast<float>(stats.BricksLeft) / unfinished : 0.0f) << (keep ? "\tkept" : "") << std::endl;
+            if (!keep)
+                continue;
+            std::string file = out + "/generated_" + std::to_string(candidate.Seed) + ".lvl";
+            if (!WriteLevelText(file.c_str(), candidate.Tiles))
+            {
+                std::cout << "ERROR: cannot write " << file << std::endl;
+                return 1;
+            }
+            ++kept;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << generated << " candidates, " << unplayable << " unplayable, " << played << " played, " << kept << " kept in "
+              << seconds << " s: " << generated * 60.0 / seconds << " candidates/min, " << ticks / seconds / 1e6 << "M ticks/s on "
+              << pool.Size() << " threads" << std::endl;
+    return kept == count ? 0 : 1;
+}
@@ -0,0 +1,49 @@
+#include "tools.h"
+
+#include <cstring>
+#include <iostream>
+
+// Command line tools built on the headless simulation; none of them
+// need a window, GPU or audio device.
+// usage: Tools <command> [options]
+
+struct Command {
+    const char* Name;
+    int (*Run)(int argc, char* argv[]);
+    const char* Help;
+};
+
+const Command Commands[] = {
+    { "bench-broadphase", BenchBroadphase, "compare brick scan and grid index lookups on synthetic levels" },
+    { "fuzz-narrowphase", FuzzNarrowphase, "check the batched narrow phase kernels against the scalar test" },
+    { "bench-narrowphase", BenchNarrowphase, "time the batched narrow phase kernels against the scalar test" },
+    { "bench-balls", BenchBalls, "time simulation ticks with 1 to 1024 balls in play" },
+    { "batch", Batch, "play seeded games per level on all cores and report completion statistics" },
+    { "replay", Replay, "play a session recorded with --record back headless at full speed" },
+    { "bench-snapshot", BenchSnapshot, "check branching from snapshots and time saving and restoring them" },
+    { "versus", Versus, "play a bot against another instance over UDP with rollback netcode" },
+    { "bench-env", BenchEnv, "check and time batched stepping of many games through the C environment interface" },
+    { "bench-effects", BenchEffects, "check and time powerup effect timers with thousands of overlapping effects" },
+    { "drops", Drops, "print the effective drop chance of each powerup for a powerups.cfg file" },
+    { "compile-level", CompileLevel, "compile a text level into the binary format loaded with mmap, or back with --text" },
+    { "bench-level-load", BenchLevelLoad, "time loading a level of a million tiles from text and compiled, and resetting it" },
+    { "bench-stream", BenchStream, "scroll a streamed level through a million rows and check it pages in constant memory" },
+    { "generate-levels", GenerateLevels, "generate levels from seeds, score them with simulated plays and keep a difficulty band" },
+    { "check-reload", CheckReload, "edit a level file repeatedly and check the watcher patches each edit into the loaded level" },
+    { "bench-catalog", BenchCatalog, "time scanning level packs and step through their levels in the menu under a memory budget" },
+};
+
+int main(int argc, char* argv[])
+{
+    if (argc >= 2)
+    {
+        for (const Command& command : Commands)
+            if (std::strcmp(argv[1], command.Name) == 0)
+                return command.Run(argc - 2, argv + 2);
+        std::cout << "Unknown command: " << argv[1] << std::endl;
+    }
+    std::cout << "usage: Tools <command> [options]\n\ncommands:\n";
+    for (const Command& command : Commands)
+        std::cout << "  " << command.Name << " - " << command.Help << "\n";
+    return 1;
+}
@@ -0,0 +1,136 @@
+#include "tools.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "collision.h"
+#include "collision_simd.h"
+
+// fills a batch with random bricks around the origin and returns a ball
+// center that is close to, inside or just touching one of them
+static glm::vec2 randomCase(std::mt19937& random, BrickBatch& batch)
+{
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f), size(0.0f, 80.0f), unit(0.0f, 1.0f);
+    batch.Count = 0;
+    unsigned int count = 1 + random() % BATCH_WIDTH;
+    for (unsigned int i = 0; i < count; ++i)
+        batch.Add(i, glm::vec2(position(random), position(random)), glm::vec2(size(random), size(random)));
+    unsigned int lane = random() % count;
+    glm::vec2 boxMin(batch.X[lane], batch.Y[lane]), boxSize(batch.W[lane], batch.H[lane]);
+    switch (random() % 4)
+    {
+    case 0: // anywhere
+        return glm::vec2(position(random), position(random));
+    case 1: // on an edge or corner of the box
+        return boxMin + boxSize * glm::vec2(static_cast<float>(random() % 3) / 2.0f, static_cast<float>(random() % 3) / 2.0f);
+    case 2: // inside the box
+        return boxMin + boxSize * glm::vec2(unit(random), unit(random));
+    default: // a radius away from an edge, where the test is decided by rounding
+        return boxMin + glm::vec2(-12.5f, boxSize.y * unit(random));
+    }
+}
+
+// Checks the batched narrow phase against the scalar CheckCollision on random
+// and edge-case inputs, for every kernel this CPU supports. The batched test
+// compares squared distances where the scalar one compares lengths, so a lane
+// may only disagree when the distance is within rounding of the radius.
+// usage: Tools fuzz-narrowphase [cases] [seed]
+int FuzzNarrowphase(int argc, char* argv[])
+{
+    unsigned int cases = argc > 0 ? std::atoi(argv[0]) : 1000000;
+    std::mt19937 random(argc > 1 ? std::atoi(argv[1]) : 1234);
+    const float radius = 12.5f;
+    SimdLevel best = SupportedSimdLevel();
+    unsigned int lanes = 0, hits = 0, borderline = 0;
+    BrickBatch batch;
+    for (unsigned int c = 0; c < cases; ++c)
+    {
+        BallObject ball(randomCase(random, batch) - radius, radius, glm::vec2(0.0f));
+        // the center is derived from the ball position the way the simulation does it
+        glm::vec2 center = ball.Position + radius;
+        for (int level = SIMD_SCALAR; level <= best; ++level)
+        {
+            BatchContacts contacts;
+            unsigned int mask = CollideBatch(static_cast<SimdLevel>(level), center, radius, batch, contacts);
+            for (unsigned int i = 0; i < batch.Count; ++i)
+            {
+                Collision expected = CheckCollision(ball, glm::vec2(batch.X[i], batch.Y[i]), glm::vec2(batch.W[i], batch.H[i]));
+                bool hit = (mask >> i) & 1;
+                glm::vec2 contact(contacts.X[i], contacts.Y[i]);
+                ++lanes;
+                if (hit != std::get<0>(expected))
+                {
+                    if (std::abs(glm::length(contact) - radius) < 1e-4f * radius)
+                    {
+                        ++borderline;
+                        continue;
+                    }
+                }
+                else if (!hit || contact == std::get<2>(expected))
+                {
+                    hits += hit;
+                    continue;
+                }
+                std::cout << "ERROR: " << SimdLevelName(static_cast<SimdLevel>(level)) << " case " << c << " lane " << i
+                          << ": ball (" << center.x << ", " << center.y << ") brick (" << batch.X[i] << ", " << batch.Y[i]
+                          << ", " << batch.W[i] << ", " << batch.H[i] << ") hit " << hit << ", expected " << std::get<0>(expected) << std::endl;
+                return 1;
+            }
+        }
+    }
+    std::cout << "kernels up to " << SimdLevelName(best) << ": " << lanes << " lanes, " << hits << " hits, "
+              << borderline << " borderline disagreements" << std::endl;
+    return 0;
+}
+
+// Times every supported kernel of the batched narrow phase against calling
+// the scalar CheckCollision once per brick.
+// usage: Tools bench-narrowphase [batches]
+int BenchNarrowphase(int argc, char* argv[])
+{
+    unsigned int count = argc > 0 ? std::atoi(argv[0]) : 1000000;
+    std::mt19937 random(1234);
+    std::vector<BrickBatch> batches(1024);
+    std::vector<glm::vec2> centers(batches.size());
+    const float radius = 12.5f;
+    for (unsigned int i = 0; i < batches.size(); ++i)
+    {
+        // rounded through the ball position so both sides see the same center
+        centers[i] = (randomCase(random, batches[i]) - radius) + radius;
+        while (batches[i].Count < BATCH_WIDTH)
+            batches[i].Add(batches[i].Count, glm::vec2(centers[i].x - 40.0f, centers[i].y), glm::vec2(20.0f));
+    }
+    std::cout << "kernel\tns/brick\thits" << std::endl;
+
+    unsigned int hits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int n = 0; n < count; ++n)
+    {
+        const BrickBatch& batch = batches[n % batches.size()];
+        BallObject ball(centers[n % batches.size()] - radius, radius, glm::vec2(0.0f));
+        for (unsigned int i = 0; i < BATCH_WIDTH; ++i)
+            hits += std::get<0>(CheckCollision(ball, glm::vec2(batch.X[i], batch.Y[i]), glm::vec2(batch.W[i], batch.H[i])));
+    }
+    auto end = std::chrono::steady_clock::now();
+    std::cout << "reference\t" << std::chrono::duration<double, std::nano>(end - start).count() / (count * BATCH_WIDTH) << "\t" << hits << std::endl;
+
+    for (int level = SIMD_SCALAR; level <= SupportedSimdLevel(); ++level)
+    {
+        hits = 0;
+        BatchContacts contacts;
+        start = std::chrono::steady_clock::now();
+        for (unsigned int n = 0; n < count; ++n)
+        {
+            unsigned int mask = CollideBatch(static_cast<SimdLevel>(level), centers[n % batches.size()], radius, batches[n % batches.size()], contacts);
+            for (; mask; mask &= mask - 1)
+                ++hits;
+        }
+        end = std::chrono::steady_clock::now();
+        std::cout << SimdLevelName(static_cast<SimdLevel>(level)) << "\t" << std::chrono::duration<double, std::nano>(end - start).count() / (count * BATCH_WIDTH) << "\t" << hits << std::endl;
+    }
+    return 0;
+}
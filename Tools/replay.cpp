@@ -0,0 +1,56 @@
+#include "tools.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "input_recording.h"
+
+// Plays a session recorded with the client's --record option back at full
+// speed without a window and prints the state it ends in, which matches
+// what the player saw. Run from the directory holding levels/.
+// usage: Tools replay <file> [--repeat n]
+int Replay(int argc, char* argv[])
+{
+    if (argc < 1)
+    {
+        std::cout << "usage: Tools replay <file> [--repeat n]" << std::endl;
+        return 1;
+    }
+    unsigned int repeat = 1;
+    if (argc >= 3 && std::strcmp(argv[1], "--repeat") == 0)
+        repeat = std::max(1, std::atoi(argv[2]));
+    InputRecording recording;
+    if (!recording.Load(argv[0]))
+    {
+        std::cout << "ERROR: cannot read recording " << argv[0] << std::endl;
+        return 1;
+    }
+    std::cout << recording.Ticks << " ticks at " << recording.TickRate << " Hz in " << recording.Events.size()
+              << " bytes of events, seed " << recording.Seed << std::endl;
+
+    float dt = recording.TickLength();
+    Simulation sim(recording.Width, recording.Height);
+    std::chrono::steady_clock::duration total(0);
+    for (unsigned int run = 0; run < repeat; ++run)
+    {
+        recording.Start(sim);
+        InputPlayback playback(recording);
+        auto start = std::chrono::steady_clock::now();
+        while (!playback.Done())
+        {
+            sim.ProcessKeys(dt, playback.Next());
+            sim.Update(dt);
+        }
+        total += std::chrono::steady_clock::now() - start;
+    }
+    double ms = std::chrono::duration<double, std::milli>(total).count() / repeat;
+
+    const char* states[] = { "active", "menu", "won" };
+    std::cout << "end: " << states[sim.State] << ", level " << sim.Level << ", lives " << sim.Lives << ", "
+              << sim.Levels[sim.Level].Progress().Remaining << " bricks left, " << sim.Balls.Size() << " balls" << std::endl;
+    std::cout << ms << " ms per replay, " << recording.Ticks / ms << " ticks/ms" << std::endl;
+    return 0;
+}
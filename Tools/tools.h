@@ -0,0 +1,43 @@
+#ifndef TOOLS_H
+#define TOOLS_H
+
+// Each command of the Tools executable is a function taking the
+// arguments that follow the command name on the command line and
+// returning the process exit code.
+
+// times the full brick scan against the grid index on synthetic levels
+int BenchBroadphase(int argc, char* argv[]);
+// checks the batched narrow phase kernels against the scalar collision test
+int FuzzNarrowphase(int argc, char* argv[]);
+// times the batched narrow phase kernels against the scalar collision test
+int BenchNarrowphase(int argc, char* argv[]);
+// times simulation ticks with growing numbers of balls in play
+int BenchBalls(int argc, char* argv[]);
+// plays seeded games on all cores with an automatic paddle and reports level statistics
+int Batch(int argc, char* argv[]);
+// plays a recorded session back headless and prints where it ends
+int Replay(int argc, char* argv[]);
+// checks that restored snapshots play on identically and times saving and restoring them
+int BenchSnapshot(int argc, char* argv[]);
+// plays one side of a rollback versus game against another instance over UDP
+int Versus(int argc, char* argv[]);
+// steps a batch of games through the C environment interface and times it
+int BenchEnv(int argc, char* argv[]);
+// checks the powerup effect timers against a scanned list under thousands of overlapping effects
+int BenchEffects(int argc, char* argv[]);
+// prints the effective chance of each powerup drop for a drop chance file
+int Drops(int argc, char* argv[]);
+// compiles a text level into the binary level format, or back
+int CompileLevel(int argc, char* argv[]);
+// times loading a large level from text and from its compiled form
+int BenchLevelLoad(int argc, char* argv[]);
+// scrolls a streamed level through millions of rows and checks that it plays in constant memory
+int BenchStream(int argc, char* argv[]);
+// generates levels from seeds and keeps the ones whose simulated clear rate falls into a difficulty band
+int GenerateLevels(int argc, char* argv[]);
+// edits a level file over and over and checks every edit is watched and patched into the loaded level
+int CheckReload(int argc, char* argv[]);
+// times scanning many level packs and steps through them in the menu under a small memory budget
+int BenchCatalog(int argc, char* argv[]);
+
+#endif
@@ -0,0 +1,165 @@
+#include "tools.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "rollback_session.h"
+#include "udp_link.h"
+
+// keys for a paddle chasing the ball closest to it, missing it by up to
+// 40 pixels either way as drawn from input; launches right away
+static unsigned int botKeys(const Simulation& sim, unsigned int player, Pcg32& input)
+{
+    const GameObject& paddle = player == PLAYER_TWO ? sim.Opponent : sim.Player;
+    float center = paddle.Position.x + paddle.Size.x / 2.0f;
+    float target = center, distance = 1e9f;
+    for (unsigned int i = 0; i < sim.Balls.Size(); ++i)
+    {
+        float d = std::abs(sim.Balls.Positions[i].y - paddle.Position.y);
+        if (d < distance)
+        {
+            distance = d;
+            target = sim.Balls.Positions[i].x + sim.Balls.Radius;
+        }
+    }
+    target += static_cast<float>(input.Below(81)) - 40.0f;
+    unsigned int keys = GAME_KEY_LAUNCH;
+    if (target < center - 5.0f)
+        keys |= GAME_KEY_LEFT;
+    if (target > center + 5.0f)
+        keys |= GAME_KEY_RIGHT;
+    return keys;
+}
+
+// Plays one side of a versus game against another instance over UDP,
+// with a bot on the keys, at 120 ticks per second. Both sides print the
+// checksum of the state after the last tick, which has to match, along
+// with rollback statistics; the link can add latency, jitter and loss.
+// Run from the directory holding levels/, e.g. in two terminals:
+//   Tools versus --player 1 --port 7001 --peer 127.0.0.1:7002 --latency 40 --loss 0.1
+//   Tools versus --player 2 --port 7002 --peer 127.0.0.1:7001 --latency 40 --loss 0.1
+// usage: Tools versus --player 1|2 --port n --peer host:port [--delay ticks] [--latency ms]
+//                     [--jitter ms] [--loss fraction] [--ticks n] [--level n] [--seed s]
+int Versus(int argc, char* argv[])
+{
+    unsigned int player = 1, port = 0, peerPort = 0, delay = 2, ticks = 3600, level = 0, seed = 1;
+    std::string peerHost = "127.0.0.1";
+    LinkConditions conditions;
+    for (int i = 0; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--player") == 0 && i + 1 < argc)
+            player = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--port") == 0 && i + 1 < argc)
+            port = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--peer") == 0 && i + 1 < argc)
+        {
+            std::string peer = argv[++i];
+            size_t colon = peer.rfind(':');
+            peerHost = peer.substr(0, colon);
+            peerPort = colon == std::string::npos ? 0 : std::atoi(peer.c_str() + colon + 1);
+        }
+        else if (std::strcmp(argv[i], "--delay") == 0 && i + 1 < argc)
+            delay = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--latency") == 0 && i + 1 < argc)
+            conditions.LatencyMs = static_cast<float>(std::atof(argv[++i]));
+        else if (std::strcmp(argv[i], "--jitter") == 0 && i + 1 < argc)
+            conditions.JitterMs = static_cast<float>(std::atof(argv[++i]));
+        else if (std::strcmp(argv[i], "--loss") == 0 && i + 1 < argc)
+            conditions.Loss = static_cast<float>(std::atof(argv[++i]));
+        else if (std::strcmp(argv[i], "--ticks") == 0 && i + 1 < argc)
+            ticks = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--level") == 0 && i + 1 < argc)
+            level = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            seed = std::atoi(argv[++i]);
+    }
+    if ((player != 1 && player != 2) || port == 0 || peerPort == 0)
+    {
+        std::cout << "usage: Tools versus --player 1|2 --port n --peer host:port [--delay ticks] [--latency ms]\n"
+                     "                    [--jitter ms] [--loss fraction] [--ticks n] [--level n] [--seed s]" << std::endl;
+        return 1;
+    }
+    UdpLink link;
+    link.Conditions = conditions;
+    if (!link.Open(static_cast<unsigned short>(port), peerHost.c_str(), static_cast<unsigned short>(peerPort), player))
+    {
+        std::cout << "ERROR: cannot open port " << port << " to " << peerHost << ":" << peerPort << std::endl;
+        return 1;
+    }
+    Simulation sim(800, 600);
+    sim.Seed(seed);
+    sim.LoadLevels();
+    if (level >= sim.Levels.size())
+    {
+        std::cout << "ERROR: no level " << level << std::endl;
+        return 1;
+    }
+    sim.StartVersus(level);
+    const float tickLength = 1.0f / 120.0f;
+    RollbackSession session(sim, player - 1, delay, tickLength);
+    Pcg32 input(seed, player);
+
+    unsigned char packet[MAX_VERSUS_PACKET];
+    auto tickDuration = std::chrono::microseconds(static_cast<long long>(tickLength * 1e6f));
+    auto next = std::chrono::steady_clock::now();
+    auto deadline = next;
+    bool finished = false, settled = false;
+    for (;;)
+    {
+        while (size_t size = link.Receive(packet, sizeof(packet)))
+            session.Receive(packet, size);
+        auto now = std::chrono::steady_clock::now();
+        if (session.Tick < ticks)
+            session.Advance(botKeys(sim, player - 1, input));
+        else if (!finished)
+        {
+            finished = true;
+            deadline = now + std::chrono::seconds(10);
+        }
+        // after the last tick, wait until every key is known both ways and keep acknowledging a little longer
+        if (finished && !settled && session.Resolve() && session.Delivered())
+        {
+            settled = true;
+            deadline = now + std::chrono::milliseconds(500);
+        }
+        if ((finished && now >= deadline) || session.Failed)
+            break;
+        link.Send(packet, session.WritePacket(packet, sizeof(packet)));
+        next += tickDuration;
+        std::this_thread::sleep_until(next);
+    }
+
+    if (session.Failed)
+    {
+        std::cout << "ERROR: player " << player << " stopped at tick " << session.Tick << ": the state outgrew its rollback snapshot" << std::endl;
+        return 1;
+    }
+    std::unique_ptr<SimSnapshot> state(new SimSnapshot());
+    state->Save(sim);
+    std::cout << "player " << player << ": " << session.Tick << " ticks, checksum " << std::hex << RollbackSession::Checksum(*state) << std::dec
+              << (settled ? "" : " (peer never confirmed the last ticks)") << std::endl;
+    std::cout << "scores " << sim.Scores[PLAYER_ONE] << ":" << sim.Scores[PLAYER_TWO] << ", lives " << sim.Lives << ":" << sim.OpponentLives
+              << (sim.State == GAME_WIN ? (sim.Winner == NO_WINNER ? ", draw" : sim.Winner == PLAYER_ONE ? ", player 1 won" : ", player 2 won") : "") << std::endl;
+    std::cout << "rollbacks " << session.Rollbacks << ", ticks resimulated " << session.RolledBackTicks << ", longest " << session.LongestRollback
+              << " ticks, slowest " << session.SlowestRollbackMs << " ms" << std::endl;
+    std::cout << "stalls " << session.Stalls << ", waits " << session.Waits << ", desync " << (session.Desynced ? "YES" : "no") << std::endl;
+
+    // how long a full window rollback takes on this machine
+    const unsigned int iterations = 200;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < iterations; ++i)
+    {
+        state->Restore(sim);
+        for (unsigned int tick = 0; tick < MAX_PREDICTION; ++tick)
+            sim.StepVersus(tickLength, SimInput(), SimInput());
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+    std::cout << "restoring and resimulating " << MAX_PREDICTION << " ticks: " << ms << " ms" << std::endl;
+    return session.Desynced || !settled ? 1 : 0;
+}